@@ -0,0 +1,33 @@
+/*
+   Checks for the host test programs.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+*/
+
+#ifndef HOST_CHECK_HPP
+#define HOST_CHECK_HPP
+
+#include <cstdio>
+
+namespace host_test {
+
+    inline unsigned int failures = 0;
+
+    /** Report a failed check, the program result is non-zero. */
+    inline void check(bool ok, const char *what) {
+        if (!ok) {
+            std::printf("FAIL: %s\n", what);
+            failures++;
+        }
+    }
+
+    /** Print the number of failures, and return the exit status of the test program. */
+    inline int result(const char *name) {
+        std::printf("%s: %u failures\n", name, failures);
+        return (failures == 0) ? 0 : 1;
+    }
+}
+
+#endif // #ifndef HOST_CHECK_HPP
@@ -0,0 +1,273 @@
+/*
+   Host harness for the bit-banged serial engines.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Runs the spi_engine, i2c_engine and uart_tx_engine bit loops natively on
+   GPIO registers in host memory. The mcycle counter is modelled by
+   cycle_pacer::host_mcycle, which advances one cycle on each read, samples
+   the driven register and runs the model of the remote device.
+   Returns non-zero if a check fails.
+
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "bitbang.hpp"
+
+#include "check.hpp"
+
+using host_test::check;
+
+namespace {
+
+    /** Simulated GPIO registers and mcycle counter */
+    struct sim_port {
+        volatile std::uint32_t input_val = 0;
+        volatile std::uint32_t drive = 0;
+        std::uint32_t shadow = 0;
+        // Value of the driven register at each cycle
+        std::vector<std::uint32_t> samples;
+        // Remote device, updates input_val from the driven register
+        std::function<void(std::uint32_t drive)> device;
+
+        /** Clear the trace, the driven register starts at a value. */
+        void reset(std::uint32_t value) {
+            drive = value;
+            shadow = value;
+            samples.clear();
+            device = nullptr;
+        }
+        /** Port on the registers, with or without a shadow register. */
+        driver::bitbang_port port(bool shadowed) {
+            return driver::bitbang_port(&input_val, &drive, shadowed ? &shadow : nullptr);
+        }
+        /** Cycles at which any of the mask bits changed */
+        std::vector<std::size_t> edges(std::uint32_t mask) const {
+            std::vector<std::size_t> cycles;
+            for (std::size_t i = 1; i < samples.size(); i++) {
+                if ((samples[i] ^ samples[i-1]) & mask) {
+                    cycles.push_back(i);
+                }
+            }
+            return cycles;
+        }
+    } sim;
+
+    std::uint32_t sim_mcycle(void) {
+        const std::uint32_t drive = sim.drive;
+        sim.samples.push_back(drive);
+        if (sim.device) {
+            sim.device(drive);
+        }
+        return static_cast<std::uint32_t>(sim.samples.size());
+    }
+
+    /** Sample the register after the last write of a bit loop. */
+    void flush(void) {
+        sim_mcycle();
+    }
+
+    /** Mode 0, MSB first, each half bit is the same number of cycles. */
+    void test_spi(bool shadowed) {
+        constexpr std::uint32_t SCK = 1U << 0;
+        constexpr std::uint32_t MOSI = 1U << 1;
+        constexpr std::uint32_t MISO = 1U << 2;
+        constexpr std::uint32_t CYCLES_PER_BIT = 20;
+        sim.reset(1U << 8);
+        // The slave shifts out on the falling edge, and samples on the rising edge.
+        std::uint8_t slave_tx = 0xC1;
+        std::uint8_t slave_rx = 0;
+        std::uint32_t previous = sim.drive;
+        sim.input_val = (slave_tx & 0x80) ? MISO : 0;
+        sim.device = [&] (std::uint32_t drive) {
+            if ((drive & SCK) && !(previous & SCK)) {
+                slave_rx = (slave_rx << 1) | ((drive & MOSI) ? 1 : 0);
+            }
+            if (!(drive & SCK) && (previous & SCK)) {
+                slave_tx <<= 1;
+                sim.input_val = (slave_tx & 0x80) ? MISO : 0;
+            }
+            previous = drive;
+        };
+        driver::spi_engine spi(sim.port(shadowed), SCK, MOSI, MISO, CYCLES_PER_BIT);
+        const std::uint8_t rx = spi.transfer(0x4D);
+        flush();
+        check(rx == 0xC1, "SPI receives MSB first");
+        check(slave_rx == 0x4D, "SPI transmits MSB first");
+
+        const auto sck = sim.edges(SCK);
+        bool half_bits = sck.size() == 16;
+        for (std::size_t i = 1; half_bits && (i < sck.size()); i++) {
+            half_bits = (sck[i] - sck[i-1]) == CYCLES_PER_BIT/2;
+        }
+        check(half_bits, "SPI clock edges every half bit");
+        bool setup = true;
+        for (std::size_t i = 0; i < sck.size(); i += 2) {
+            // MOSI is stable at the rising edge of SCK
+            setup = setup && (sim.samples[sck[i]] & SCK) && !((sim.samples[sck[i]] ^ sim.samples[sck[i]-1]) & MOSI);
+        }
+        check(setup, "SPI data is set up before the rising edge");
+        check(!(sim.drive & SCK), "SPI clock idles low");
+        check((sim.drive & (1U << 8)) != 0, "SPI keeps the other outputs");
+    }
+
+    /** 8N1, LSB first, each bit is the same number of cycles. */
+    void test_uart_tx(bool shadowed) {
+        constexpr std::uint32_t TX = 1U << 3;
+        constexpr std::uint32_t CYCLES_PER_BIT = 16;
+        sim.reset(TX);
+        driver::uart_tx_engine uart(sim.port(shadowed), TX, CYCLES_PER_BIT);
+        uart.write(0x4B);
+        flush();
+        const auto tx = sim.edges(TX);
+        check(!tx.empty() && !(sim.samples[tx[0]] & TX), "UART start bit");
+        bool bit_aligned = true;
+        for (std::size_t i = 1; i < tx.size(); i++) {
+            bit_aligned = bit_aligned && (((tx[i] - tx[0]) % CYCLES_PER_BIT) == 0);
+        }
+        check(bit_aligned, "UART edges on the bit boundaries");
+        // Sample the middle of each bit
+        std::uint32_t frame = 0;
+        for (unsigned int bit = 0; !tx.empty() && (bit < 10); bit++) {
+            const std::size_t cycle = tx[0] + bit*CYCLES_PER_BIT + CYCLES_PER_BIT/2;
+            const std::uint32_t level = (cycle < sim.samples.size()) ? sim.samples[cycle] : sim.drive;
+            frame |= ((level & TX) ? 1U : 0U) << bit;
+        }
+        check(frame == ((0x4BU << 1) | (1U << 9)), "UART frame, start bit, LSB first, stop bit");
+        check((sim.samples.size() - tx[0]) >= 10*CYCLES_PER_BIT, "UART stop bit lasts a bit period");
+        check((sim.drive & TX) != 0, "UART idles high");
+    }
+
+    /** I2C slave on open drain lines. A set drive bit pulls a line low. */
+    struct i2c_slave {
+        static constexpr std::uint32_t SCL = 1U << 4;
+        static constexpr std::uint32_t SDA = 1U << 5;
+
+        std::uint32_t pull = 0;
+        std::uint32_t previous = SCL | SDA;
+        unsigned int starts = 0;
+        unsigned int stops = 0;
+        // SDA changed while SCL was high, other than a start or stop
+        unsigned int data_errors = 0;
+        // SCL clocks since the start of the byte, the 9th is the acknowledge
+        int clock = 0;
+        std::uint8_t shift = 0;
+        std::vector<std::uint8_t> received;
+        std::uint8_t tx = 0;
+        bool transmitting = false;
+        bool master_ack = false;
+        bool hold_scl = false;
+
+        void update(std::uint32_t drive) {
+            const std::uint32_t lines = ~(drive | pull | (hold_scl ? SCL : 0)) & (SCL | SDA);
+            const std::uint32_t changed = lines ^ previous;
+            if ((changed & SDA) && (lines & SCL) && (previous & SCL)) {
+                if (lines & SDA) {
+                    stops++;
+                } else {
+                    starts++;
+                    clock = -1;
+                    transmitting = false;
+                }
+                pull = 0;
+            } else if ((changed & SCL) && (lines & SCL)) {
+                // Rising edge, the data is sampled
+                if ((clock >= 0) && (clock < 8) && !transmitting) {
+                    shift = (shift << 1) | ((lines & SDA) ? 1 : 0);
+                } else if ((clock == 8) && transmitting) {
+                    master_ack = !(lines & SDA);
+                }
+            } else if ((changed & SCL) && !(lines & SCL)) {
+                // Falling edge, the data may change
+                clock++;
+                if (clock == 8) {
+                    if (!transmitting) {
+                        received.push_back(shift);
+                        pull = SDA;
+                    } else {
+                        pull = 0;
+                    }
+                } else if (clock == 9) {
+                    clock = 0;
+                    // The slave transmits after a read address
+                    transmitting = transmitting || ((received.size() == 1) && (received[0] & 1));
+                    pull = 0;
+                }
+                if (transmitting && (clock >= 0) && (clock < 8)) {
+                    pull = (tx & (0x80 >> clock)) ? 0 : SDA;
+                }
+            } else if ((changed & SDA) && (lines & SCL)) {
+                data_errors++;
+            }
+            previous = lines;
+            sim.input_val = lines;
+        }
+    };
+
+    /** Start, address and data bytes, acknowledges and stop on the open drain lines. */
+    void test_i2c(bool shadowed) {
+        constexpr std::uint32_t SCL = i2c_slave::SCL;
+        constexpr std::uint32_t SDA = i2c_slave::SDA;
+        constexpr std::uint32_t CYCLES_PER_BIT = 20;
+        sim.reset(0);
+        sim.input_val = SCL | SDA;
+        i2c_slave slave;
+        sim.device = [&slave] (std::uint32_t drive) { slave.update(drive); };
+        driver::i2c_engine i2c(sim.port(shadowed), SCL, SDA, CYCLES_PER_BIT);
+
+        // Write transfer
+        check(i2c.start(), "I2C start");
+        check(i2c.write(0xA4), "I2C address acknowledged");
+        check(i2c.write(0x1E), "I2C data acknowledged");
+        i2c.stop();
+        flush();
+        check((slave.starts == 1) && (slave.stops == 1), "I2C start and stop conditions");
+        check((slave.received.size() == 2) && (slave.received[0] == 0xA4) && (slave.received[1] == 0x1E),
+              "I2C writes MSB first");
+        check(slave.data_errors == 0, "I2C data only changes while the clock is low");
+        // 9 clocks for each byte
+        const auto scl = sim.edges(SCL);
+        unsigned int falling = 0;
+        for (auto cycle : scl) {
+            falling += (sim.samples[cycle] & SCL) ? 1 : 0;
+        }
+        check(falling == 1 + 2*9, "I2C clock pulses, the start and 9 for each byte");
+        check((sim.drive & (SCL | SDA)) == 0, "I2C lines released after the stop");
+
+        // Read transfer
+        slave = i2c_slave();
+        slave.tx = 0x96;
+        sim.input_val = SCL | SDA;
+        check(i2c.start(), "I2C start for a read");
+        check(i2c.write(0xA5), "I2C read address acknowledged");
+        check(i2c.read(false) == 0x96, "I2C reads MSB first");
+        i2c.stop();
+        flush();
+        check(!slave.master_ack, "I2C last byte of a read is not acknowledged");
+        check((slave.starts == 1) && (slave.stops == 1) && (slave.data_errors == 0), "I2C read conditions");
+
+        // The slave holds the clock low for longer than the stretch limit
+        slave = i2c_slave();
+        slave.hold_scl = true;
+        sim.input_val = SDA;
+        const std::size_t start = sim.samples.size();
+        check(!i2c.write(0x00), "I2C clock stretch timeout");
+        const std::size_t cycles = sim.samples.size() - start;
+        check(cycles >= driver::i2c_engine::STRETCH_LIMIT * CYCLES_PER_BIT/2, "I2C waits for the stretched clock");
+    }
+}
+
+int main(void) {
+    driver::cycle_pacer::host_mcycle = sim_mcycle;
+    for (bool shadowed : { false, true }) {
+        test_spi(shadowed);
+        test_uart_tx(shadowed);
+        test_i2c(shadowed);
+    }
+    return host_test::result("sim_bitbang");
+}
@@ -0,0 +1,171 @@
+/*
+   Host harness for the coroutine scheduler on the simulated MMIO register file.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Runs coroutine tasks natively with mmio_sim::sim_access. Sleeps are
+   software timers on the timer wheel, the mti interrupt is modelled by
+   polling mtimecmp and the idle loop drains the ready queue.
+   Built with -std=c++20, the rest of the host build is C++17.
+   Returns non-zero if a check fails.
+
+*/
+
+#include <cstdint>
+#include <chrono>
+
+#include "mmio_sim.hpp"
+#include "timer.hpp"
+#include "timer_wheel.hpp"
+#include "work_queue.hpp"
+#include "coroutine.hpp"
+
+#include "check.hpp"
+#include "sim_mtime.hpp"
+
+using host_test::check;
+using host_test::sim_mtime;
+
+namespace {
+
+    // Start just before the low word of mtime wraps
+    constexpr std::uint64_t MTIME_START = 0xFFFFF000ULL;
+    constexpr unsigned int MAX_EVENTS = 16;
+
+    using sim_timer = driver::timer<driver::mtimer_address_spec, driver::default_timer_config, mmio_sim::sim_access>;
+    using sim_wheel = driver::timer_wheel<sim_timer>;
+    using sim_queue = irq::work_queue<8>;
+    using sim_scheduler = coro::scheduler<sim_wheel, sim_queue>;
+
+    /** Order the tasks resume in, and the simulated time of each resume. */
+    struct event_log {
+        unsigned int count = 0;
+        int id[MAX_EVENTS] = {};
+        std::uint64_t time[MAX_EVENTS] = {};
+
+        void record(int task_id, std::uint64_t now) {
+            if (count < MAX_EVENTS) {
+                id[count] = task_id;
+                time[count] = now;
+                count++;
+            }
+        }
+    };
+
+    /** The machine with one idle loop iteration per mtime tick. */
+    class sim_machine {
+    public:
+        sim_machine(void)
+            : mtime(MTIME_START)
+            , wheel(mtimer)
+            , sched(wheel, ready) {}
+
+        /** Run the idle loop for a number of mtime ticks. */
+        void run(std::uint64_t ticks) {
+            for (std::uint64_t i = 0; i < ticks; i++) {
+                mtime.advance(1);
+                if (mtime.now() >= mtimer.get_raw_time_cmp()) {
+                    wheel.process();
+                }
+                ready.drain();
+            }
+        }
+
+        sim_mtime mtime;
+        sim_timer mtimer;
+        sim_wheel wheel;
+        sim_queue ready;
+        sim_scheduler sched;
+    };
+
+    coro::task<> sleeper(sim_machine &machine, event_log &log, int id, unsigned int delay_ms, unsigned int repeat) {
+        log.record(id, machine.mtime.now());
+        for (unsigned int i = 0; i < repeat; i++) {
+            co_await machine.sched.sleep(std::chrono::milliseconds{delay_ms});
+            log.record(id, machine.mtime.now());
+        }
+    }
+
+    /** Tasks resume in the order of their sleep deadlines, at the deadline. */
+    void test_resume_order(void) {
+        sim_machine machine;
+        event_log log;
+        check(machine.sched.spawn(sleeper(machine, log, 1, 30, 1)), "spawn task 1");
+        check(machine.sched.spawn(sleeper(machine, log, 2, 10, 2)), "spawn task 2");
+        check(machine.sched.spawn(sleeper(machine, log, 3, 25, 1)), "spawn task 3");
+        const std::uint64_t start = machine.mtime.now();
+        // Tasks do not run until the idle loop
+        check(log.count == 0, "spawn() does not resume the task");
+        machine.run(1);
+        check(log.count == 3, "all tasks run to the first sleep");
+
+        machine.run(driver::default_timer_config::MTIME_FREQ_HZ / 10);
+        // Task 2 at 10ms and 20ms, task 3 at 25ms, task 1 at 30ms
+        const auto ticks = [] (unsigned int ms) {
+            return std::chrono::duration_cast<sim_wheel::timer_ticks>(std::chrono::milliseconds{ms}).count();
+        };
+        constexpr int expected_id[] = { 1, 2, 3, 2, 2, 3, 1 };
+        const std::uint64_t expected_ticks[] = { 0, 0, 0, ticks(10), 2 * ticks(10), ticks(25), ticks(30) };
+        bool order = log.count == std::size(expected_id);
+        bool timing = order;
+        for (unsigned int i = 0; order && (i < log.count); i++) {
+            order = order && (log.id[i] == expected_id[i]);
+            // The first sleeps start on the first idle loop tick.
+            timing = timing && (log.time[i] == start + 1 + expected_ticks[i]);
+        }
+        check(order, "tasks resume in the order of their deadlines");
+        check(timing, "tasks resume at their deadlines");
+        check(machine.wheel.empty(), "no timers after the tasks complete");
+        check(machine.ready.empty(), "no queued work after the tasks complete");
+    }
+
+    /** Two frames, shared by all tasks of this type. */
+    using small_task = coro::task<2>;
+
+    small_task pool_sleeper(sim_machine &machine, event_log &log, int id, unsigned int delay_ms) {
+        co_await machine.sched.sleep(std::chrono::milliseconds{delay_ms});
+        log.record(id, machine.mtime.now());
+    }
+
+    /** A frame too small for any coroutine */
+    coro::task<1, 8> oversized(void) {
+        co_return;
+    }
+
+    /** Frame pool exhaustion fails the spawn, completed tasks return their frames. */
+    void test_pool_exhaustion(void) {
+        sim_machine machine;
+        event_log log;
+        check(machine.sched.spawn(pool_sleeper(machine, log, 1, 10)), "spawn the first pooled task");
+        check(machine.sched.spawn(pool_sleeper(machine, log, 2, 20)), "spawn the second pooled task");
+        {
+            auto third = pool_sleeper(machine, log, 3, 5);
+            check(!third.valid(), "no frame for a third task");
+            check(!machine.sched.spawn(std::move(third)), "spawn fails when the pool is exhausted");
+        }
+        machine.run(driver::default_timer_config::MTIME_FREQ_HZ / 100 + 2);
+        check((log.count == 1) && (log.id[0] == 1), "the first task completed");
+        // The completed task released its frame
+        check(machine.sched.spawn(pool_sleeper(machine, log, 4, 5)), "spawn after a frame is released");
+        machine.run(driver::default_timer_config::MTIME_FREQ_HZ / 50);
+        check((log.count == 3) && (log.id[1] == 4) && (log.id[2] == 2), "the replacement task runs");
+        check(machine.sched.spawn(pool_sleeper(machine, log, 5, 1)), "frames are free after the tasks complete");
+        check(machine.sched.spawn(pool_sleeper(machine, log, 6, 1)), "both frames are free after the tasks complete");
+        machine.run(driver::default_timer_config::MTIME_FREQ_HZ / 100);
+        check(log.count == 5, "the tasks on the released frames complete");
+
+        auto too_large = oversized();
+        check(!too_large.valid(), "no frame for a coroutine larger than FRAME_SIZE");
+        check(!machine.sched.spawn(std::move(too_large)), "spawn fails for a coroutine larger than FRAME_SIZE");
+    }
+}
+
+int main(void) {
+    auto &regs = mmio_sim::register_file::instance();
+    for (auto test : { test_resume_order, test_pool_exhaustion }) {
+        regs.reset();
+        test();
+    }
+    return host_test::result("sim_coroutine");
+}
@@ -0,0 +1,733 @@
+/*
+   Host harness for the drivers on the simulated MMIO register file.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Runs the timer, timer wheel, GPIO, GPIO interrupt, PLIC, UART and PRCI
+   drivers natively with mmio_sim::sim_access, across a wrap of the mtime low word, and the
+   lock-free ring buffer and work queue.
+   Returns non-zero if a check fails.
+
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mmio_sim.hpp"
+#include "timer.hpp"
+#include "timer_wheel.hpp"
+#include "gpio.hpp"
+#include "gpio_irq.hpp"
+#include "plic.hpp"
+#include "uart.hpp"
+#include "prci.hpp"
+#include "ring_buffer.hpp"
+#include "work_queue.hpp"
+#include "device/sifive_gpio0_0_mmio_dev.hpp"
+#include "device/riscv_plic0_mmio_dev.hpp"
+
+#include "check.hpp"
+#include "sim_mtime.hpp"
+
+using host_test::check;
+using host_test::sim_mtime;
+
+namespace {
+
+    constexpr std::uintptr_t SIFIVE_GPIO0_0 = 0x10012000;
+    constexpr std::uintptr_t SIFIVE_UART0_0 = 0x10013000;
+    constexpr std::uintptr_t RISCV_PLIC0 = 0x0C000000;
+    constexpr std::uintptr_t SIFIVE_FE310_G000_PRCI = 0x10008000;
+    constexpr std::uintptr_t MTIMECMP_ADDR = driver::mtimer_address_spec::MTIMECMP_ADDR;
+    // Start just before the low word of mtime wraps
+    constexpr std::uint64_t MTIME_START = 0xFFFFF000ULL;
+
+    using sim_timer = driver::timer<driver::mtimer_address_spec, driver::default_timer_config, mmio_sim::sim_access>;
+    using sim_gpio = driver::sifive_gpio0_0_dev<SIFIVE_GPIO0_0, mmio_sim::sim_access, mmio_sim::sim_access>;
+    using sim_plic_dev = driver::riscv_plic0_dev<RISCV_PLIC0, mmio_sim::sim_access>;
+    using sim_plic = driver::plic<sim_plic_dev>;
+    using sim_gpio_irq = driver::gpio_irq<sim_gpio, sim_plic>;
+    using sim_uart = driver::uart<SIFIVE_UART0_0, driver::default_uart_config, mmio_sim::sim_access>;
+    using sim_prci = driver::prci<SIFIVE_FE310_G000_PRCI, mmio_sim::sim_access>;
+
+    // The HiFive1 Rev B core clock: 16MHz / R=2 * F=80 / Q=2 = 320MHz, no output divider.
+    using pll_320mhz = driver::pll_clock_config<320000000>;
+    static_assert((pll_320mhz::PLL.r == 2) && (pll_320mhz::PLL.f == 80) && (pll_320mhz::PLL.q == 2) &&
+                  (pll_320mhz::PLL.outdiv == 1) && (pll_320mhz::CORE_CLOCK_HZ == 320000000),
+                  "320MHz PLL divisors");
+    // The divided reference must be 6 to 12MHz.
+    static_assert(driver::solve_pll(48000000, 320000000).r == 4, "48MHz reference divided to 12MHz");
+    static_assert(driver::solve_pll(6000000, 320000000).frequency != 0, "6MHz reference");
+    static_assert(driver::solve_pll(5000000, 320000000).frequency == 0, "5MHz reference rejected");
+    static_assert(driver::solve_pll(50000000, 320000000).frequency == 0, "50MHz reference rejected");
+
+    namespace plic_param = mmio_param::riscv_plic0;
+
+    /** Simulated PLIC gateways and claim/complete, the hardware side of the PLIC registers.
+        A source asserted by a device is pending until it is claimed, and is not pending again until it is completed.
+     */
+    class sim_plic_gateway {
+    public:
+        /** Interrupt condition of the devices, a bit for each source ID. */
+        using source_lines = std::function<std::uint64_t(void)>;
+
+        explicit sim_plic_gateway(source_lines lines)
+            : _lines(lines) {
+            auto &regs = mmio_sim::register_file::instance();
+            regs.on_read(CLAIM_ADDR, [this] (std::uintptr_t addr) {
+                const std::uint32_t source = highest_pending();
+                if (source) {
+                    _pending &= ~bit(source);
+                    _in_service |= bit(source);
+                    claims.push_back(source);
+                }
+                mmio_sim::register_file::instance().poke<std::uint32_t>(addr, source);
+            });
+            regs.on_write(CLAIM_ADDR, [this] (std::uintptr_t, std::uint64_t source) {
+                completes.push_back(static_cast<std::uint32_t>(source));
+                _in_service &= ~bit(static_cast<unsigned int>(source));
+            });
+        }
+
+        std::uint32_t priority(unsigned int source) const {
+            return mmio_sim::register_file::instance().peek<std::uint32_t>(
+                RISCV_PLIC0 + plic_param::priority_r::offset + source * plic_param::priority_r::dim_increment);
+        }
+        bool enabled(unsigned int source) const {
+            const std::uint32_t enable = mmio_sim::register_file::instance().peek<std::uint32_t>(
+                RISCV_PLIC0 + plic_param::enable_r::offset + (source / 32) * plic_param::enable_r::dim_increment);
+            return (enable & (1U << (source % 32))) != 0;
+        }
+
+        std::vector<std::uint32_t> claims;
+        std::vector<std::uint32_t> completes;
+    private:
+        static constexpr std::uintptr_t CLAIM_ADDR = RISCV_PLIC0 + plic_param::claim_r::offset;
+        source_lines _lines;
+        std::uint64_t _pending = 0;
+        std::uint64_t _in_service = 0;
+
+        static constexpr std::uint64_t bit(unsigned int source) {
+            return static_cast<std::uint64_t>(1) << source;
+        }
+        /** Highest priority enabled source above the threshold, the lowest ID wins a tie. */
+        std::uint32_t highest_pending(void) {
+            _pending |= _lines() & ~_in_service;
+            const std::uint32_t threshold = mmio_sim::register_file::instance().peek<std::uint32_t>(
+                RISCV_PLIC0 + plic_param::threshold_r::offset);
+            std::uint32_t best = 0;
+            for (unsigned int source = 1; source < driver::default_plic_config::SOURCE_COUNT; source++) {
+                if ((_pending & bit(source)) && enabled(source) && (priority(source) > threshold) &&
+                    ((best == 0) || (priority(source) > priority(best)))) {
+                    best = source;
+                }
+            }
+            return best;
+        }
+    };
+
+    /** Simulated GPIO edge latches, the rise_ip and fall_ip bits are write 1 to clear. */
+    class sim_gpio_edges {
+    public:
+        sim_gpio_edges(void) {
+            latch(mmio_param::sifive_gpio0_0::rise_ip_r::offset, _rise);
+            latch(mmio_param::sifive_gpio0_0::fall_ip_r::offset, _fall);
+        }
+        void rise(unsigned int pin) {
+            _rise |= (1U << pin);
+        }
+        void fall(unsigned int pin) {
+            _fall |= (1U << pin);
+        }
+        std::uint32_t rise_pending(void) const {
+            return _rise;
+        }
+        std::uint32_t fall_pending(void) const {
+            return _fall;
+        }
+        /** PLIC source lines of the pins, the latched edges that are enabled. */
+        std::uint64_t lines(void) const {
+            auto &regs = mmio_sim::register_file::instance();
+            const std::uint32_t rise_ie = regs.peek<std::uint32_t>(reg(mmio_param::sifive_gpio0_0::rise_ie_r::offset));
+            const std::uint32_t fall_ie = regs.peek<std::uint32_t>(reg(mmio_param::sifive_gpio0_0::fall_ie_r::offset));
+            return static_cast<std::uint64_t>((_rise & rise_ie) | (_fall & fall_ie)) << driver::default_gpio_irq_config::FIRST_SOURCE;
+        }
+    private:
+        std::uint32_t _rise = 0;
+        std::uint32_t _fall = 0;
+
+        static constexpr std::uintptr_t reg(unsigned int offset) {
+            return SIFIVE_GPIO0_0 + offset;
+        }
+        void latch(unsigned int offset, std::uint32_t &latched) {
+            auto &regs = mmio_sim::register_file::instance();
+            regs.on_read(reg(offset), [&latched] (std::uintptr_t addr) {
+                mmio_sim::register_file::instance().poke<std::uint32_t>(addr, latched);
+            });
+            regs.on_write(reg(offset), [&latched] (std::uintptr_t addr, std::uint64_t value) {
+                latched &= ~static_cast<std::uint32_t>(value);
+                mmio_sim::register_file::instance().poke<std::uint32_t>(addr, latched);
+            });
+        }
+    };
+
+    namespace uart_param = mmio_param::sifive_uart0_0;
+
+    /** Simulated UART FIFOs and watermark interrupts, the hardware side of the UART registers. */
+    class sim_uart_fifo {
+    public:
+        static constexpr std::size_t FIFO_DEPTH = sim_uart::FIFO_DEPTH;
+
+        sim_uart_fifo(void) {
+            auto &regs = mmio_sim::register_file::instance();
+            regs.on_write(reg(uart_param::txdata_r::offset), [this] (std::uintptr_t, std::uint64_t value) {
+                if (tx.size() < FIFO_DEPTH) {
+                    tx.push_back(static_cast<std::uint8_t>(value));
+                } else {
+                    tx_overflows++;
+                }
+            });
+            regs.on_read(reg(uart_param::rxdata_r::offset), [this] (std::uintptr_t addr) {
+                std::uint32_t value = uart_param::rxdata_r::empty_f::bit_mask;
+                if (!rx.empty()) {
+                    value = rx.front();
+                    rx.pop_front();
+                }
+                mmio_sim::register_file::instance().poke<std::uint32_t>(addr, value);
+            });
+            regs.on_read(reg(uart_param::ip_r::offset), [this] (std::uintptr_t addr) {
+                auto &regs = mmio_sim::register_file::instance();
+                const std::uint32_t txctrl = regs.peek<std::uint32_t>(reg(uart_param::txctrl_r::offset));
+                const std::uint32_t rxctrl = regs.peek<std::uint32_t>(reg(uart_param::rxctrl_r::offset));
+                const std::size_t txcnt = (txctrl & uart_param::txctrl_r::txcnt_f::bit_mask) >> uart_param::txctrl_r::txcnt_f::bit_offset;
+                const std::size_t rxcnt = (rxctrl & uart_param::rxctrl_r::rxcnt_f::bit_mask) >> uart_param::rxctrl_r::rxcnt_f::bit_offset;
+                std::uint32_t value = 0;
+                value |= (tx.size() < txcnt) ? uart_param::ip_r::txwm_f::bit_mask : 0;
+                value |= (rx.size() > rxcnt) ? uart_param::ip_r::rxwm_f::bit_mask : 0;
+                regs.poke<std::uint32_t>(addr, value);
+            });
+        }
+        /** Receive a byte, it is dropped if the receive FIFO is full. */
+        void receive(std::uint8_t data) {
+            if (rx.size() < FIFO_DEPTH) {
+                rx.push_back(data);
+            }
+        }
+        /** Shift a byte out of the transmit FIFO to the line. */
+        bool transmit(void) {
+            if (tx.empty()) {
+                return false;
+            }
+            line.push_back(static_cast<char>(tx.front()));
+            tx.pop_front();
+            return true;
+        }
+        /** Interrupt enable register, as written by the driver. */
+        std::uint32_t ie(void) const {
+            return mmio_sim::register_file::instance().peek<std::uint32_t>(reg(uart_param::ie_r::offset));
+        }
+
+        std::deque<std::uint8_t> tx;
+        std::deque<std::uint8_t> rx;
+        std::string line;
+        unsigned int tx_overflows = 0;
+    private:
+        static constexpr std::uintptr_t reg(unsigned int offset) {
+            return SIFIVE_UART0_0 + offset;
+        }
+    };
+
+    /** 64 bit reads of mtime are consistent while the counter is running. */
+    void test_timer_read(void) {
+        sim_mtime mtime(MTIME_START);
+        sim_timer mtimer;
+        mtime.tick_on_read(true);
+        std::uint64_t previous = mtimer.get_raw_time();
+        bool monotonic = true;
+        bool bounded = true;
+        for (unsigned int i = 0; i < 0x2000; i++) {
+            const std::uint64_t before = mtime.now();
+            const std::uint64_t time = mtimer.get_raw_time();
+            monotonic = monotonic && (time > previous);
+            bounded = bounded && (time > before) && (time <= mtime.now());
+            previous = time;
+        }
+        check(monotonic, "get_raw_time() is monotonic across the mtimel wrap");
+        check(bounded, "get_raw_time() is within the simulated time of the call");
+        check(previous > 0xFFFFFFFFULL, "mtimel wrapped");
+
+        // The cached high word follows the wrap
+        mtime.tick_on_read(false);
+        mtime.advance(0x100000000ULL - (mtime.now() & 0xFFFFFFFFULL) - 0x10);
+        driver::timestamp_source<sim_timer> timestamps(mtimer);
+        bool tracking = true;
+        for (unsigned int i = 0; i < 0x20; i++) {
+            mtime.advance(1);
+            tracking = tracking && (timestamps.now() == mtime.now());
+        }
+        check(tracking, "timestamp_source follows the mtimel wrap");
+    }
+
+    /** No intermediate mtimecmp value is below the previous and new compare values. */
+    void test_timer_cmp(void) {
+        auto &regs = mmio_sim::register_file::instance();
+        sim_mtime mtime(MTIME_START);
+        sim_timer mtimer;
+        mtimer.set_raw_time_cmp_at(0xFFFFFFF0ULL);
+        std::uint64_t lowest = ~static_cast<std::uint64_t>(0);
+        auto record = [&] (std::uintptr_t, std::uint64_t) {
+            const std::uint64_t cmp = regs.peek<std::uint64_t>(MTIMECMP_ADDR);
+            lowest = (cmp < lowest) ? cmp : lowest;
+        };
+        regs.on_write(MTIMECMP_ADDR, record);
+        regs.on_write(MTIMECMP_ADDR + 4, record);
+        mtimer.set_raw_time_cmp_at(0x100000010ULL);
+        check(lowest >= 0xFFFFFFF0ULL, "no spurious mtimecmp value while it is written");
+        check(mtimer.get_raw_time_cmp() == 0x100000010ULL, "mtimecmp readback");
+    }
+
+    /** A periodic timer keeps its rate across the mtimel wrap. */
+    void test_timer_wheel(void) {
+        sim_mtime mtime(MTIME_START);
+        sim_timer mtimer;
+        sim_gpio gpio;
+        driver::pin<sim_gpio, 5> led(gpio);
+        led.output();
+        driver::timer_wheel<sim_timer> wheel(mtimer);
+        unsigned int fired = 0;
+        const auto blink = [&] (void) {
+            fired++;
+            led.toggle();
+        };
+        driver::timer_node blink_timer(blink);
+        wheel.start_periodic(blink_timer, std::chrono::milliseconds{10});
+        // 1 second, with the mti interrupt modelled by polling mtimecmp
+        for (unsigned int i = 0; i < driver::default_timer_config::MTIME_FREQ_HZ; i++) {
+            mtime.advance(1);
+            if (mtime.now() >= mtimer.get_raw_time_cmp()) {
+                wheel.process();
+            }
+        }
+        check(mtime.now() > 0xFFFFFFFFULL, "mtimel wrapped");
+        check((fired >= 99) && (fired <= 100), "periodic timer rate");
+        check(led.read() == ((fired & 1) != 0), "LED toggled by the timer");
+        wheel.cancel(blink_timer);
+    }
+
+    /** A timer restarted with no offset from its own callback expires once per tick. */
+    void test_timer_wheel_restart(void) {
+        sim_mtime mtime(MTIME_START);
+        sim_timer mtimer;
+        driver::timer_wheel<sim_timer> wheel(mtimer);
+        unsigned int fired = 0;
+        driver::timer_node *self = nullptr;
+        const auto restart = [&] (void) {
+            fired++;
+            wheel.start_raw(*self, 0, 0);
+        };
+        driver::timer_node restart_timer(restart);
+        self = &restart_timer;
+        wheel.start_raw(restart_timer, 0, 0);
+        mtime.advance(1);
+        wheel.process();
+        check(fired == 1, "a restarted timer does not expire again in the same process()");
+        check(mtimer.get_raw_time_cmp() == mtime.now() + 1, "a restarted timer expires on the next tick");
+        for (unsigned int i = 0; i < 10; i++) {
+            mtime.advance(1);
+            wheel.process();
+        }
+        check(fired == 11, "a restarted timer expires once per tick");
+        wheel.cancel(restart_timer);
+        check(wheel.empty(), "cancel a restarted timer");
+    }
+
+    /** dispatch() claims the pending sources in priority order, and completes each claimed source. */
+    void test_plic_dispatch(void) {
+        std::uint64_t asserted = 0;
+        sim_plic_gateway gateway([&asserted] (void) {
+            const std::uint64_t lines = asserted;
+            // Source 6 is a pulse, it has no handler to clear it.
+            asserted &= ~(1ULL << 6);
+            return lines;
+        });
+        sim_plic_dev plic_dev;
+        sim_plic plic(plic_dev);
+        std::vector<unsigned int> handled;
+        // Each handler clears the interrupt condition of its device.
+        const auto handler_3 = [&] (void) { handled.push_back(3); asserted &= ~(1ULL << 3); };
+        const auto handler_5 = [&] (void) { handled.push_back(5); asserted &= ~(1ULL << 5); };
+        plic.bind<3>(handler_3);
+        plic.bind<5>(handler_5);
+        plic.enable<3>(1);
+        plic.enable<5>(7);
+        // Enabled with no handler
+        plic.enable<6>(2);
+        // Pending, but never enabled.
+        plic.bind<7>(handler_3);
+        check(gateway.enabled(3) && gateway.enabled(5) && !gateway.enabled(7), "enable() sets the enable bits");
+        check((gateway.priority(3) == 1) && (gateway.priority(5) == 7), "enable() sets the priority");
+
+        asserted = (1ULL << 3) | (1ULL << 5) | (1ULL << 6) | (1ULL << 7);
+        plic.dispatch();
+        check((handled.size() == 2) && (handled[0] == 5) && (handled[1] == 3), "handlers called in priority order");
+        check((gateway.claims.size() == 3) && (gateway.claims[0] == 5) && (gateway.claims[1] == 6) && (gateway.claims[2] == 3),
+              "sources claimed in priority order");
+        check(gateway.completes == gateway.claims, "each claimed source is completed");
+        check(asserted == (1ULL << 7), "only the bound handlers run");
+
+        // A source that is still asserted after completion is claimed again.
+        bool hold_2 = true;
+        const auto handler_2 = [&] (void) {
+            handled.push_back(2);
+            // The first call does not clear the interrupt condition.
+            if (!hold_2) {
+                asserted &= ~(1ULL << 2);
+            }
+            hold_2 = false;
+        };
+        plic.bind<2>(handler_2);
+        plic.enable<2>(3);
+        plic.disable<6>();
+        gateway.claims.clear();
+        gateway.completes.clear();
+        asserted |= (1ULL << 2);
+        plic.dispatch();
+        check((handled.size() == 4) && (handled[2] == 2) && (handled[3] == 2), "an asserted source is claimed after completion");
+        check((gateway.claims.size() == 2) && (gateway.completes == gateway.claims), "claimed sources completed");
+
+        // Sources at or below the threshold are not claimed.
+        plic.set_threshold(3);
+        asserted |= (1ULL << 2);
+        plic.dispatch();
+        check(handled.size() == 4, "no claim at the threshold");
+        plic.set_threshold(0);
+        plic.dispatch();
+        check(handled.size() == 5, "claimed below the threshold");
+        plic.unbind<2>();
+        plic.unbind<3>();
+        plic.unbind<5>();
+        plic.unbind<7>();
+    }
+
+    /** The pin handler clears only the edges of its pin before calling the edge handlers. */
+    void test_gpio_irq(void) {
+        sim_gpio_edges edges;
+        sim_plic_gateway gateway([&edges] (void) { return edges.lines(); });
+        sim_plic_dev plic_dev;
+        sim_plic plic(plic_dev);
+        sim_gpio gpio;
+        constexpr unsigned int BUTTON = 2;
+        constexpr unsigned int ENCODER = 3;
+        constexpr unsigned int BUTTON_SOURCE = driver::default_gpio_irq_config::FIRST_SOURCE + BUTTON;
+        constexpr unsigned int ENCODER_SOURCE = driver::default_gpio_irq_config::FIRST_SOURCE + ENCODER;
+        gpio.output_en.write((1U << BUTTON) | (1U << 5));
+        // Latched before the handler is attached
+        edges.fall(BUTTON);
+        edges.rise(ENCODER);
+
+        sim_gpio_irq gpio_irq(gpio, plic);
+        unsigned int pressed = 0;
+        unsigned int encoder = 0;
+        const auto button_pressed = [&] (void) {
+            // An edge during the handler is latched again
+            if (pressed++ == 0) {
+                edges.fall(BUTTON);
+            }
+        };
+        const auto encoder_edge = [&] (void) { encoder++; };
+        gpio_irq.attach<BUTTON, driver::edge::fall>(button_pressed);
+        gpio_irq.attach<ENCODER, driver::edge::both>(encoder_edge);
+        check(gpio.output_en.read() == (1U << 5), "attach() disables the output of the pin");
+        check(gpio.input_en.read() == ((1U << BUTTON) | (1U << ENCODER)), "attach() enables the input of the pin");
+        check((gpio.fall_ie.read() == ((1U << BUTTON) | (1U << ENCODER))) && (gpio.rise_ie.read() == (1U << ENCODER)),
+              "attach() enables the edges");
+        check((edges.fall_pending() == 0) && (edges.rise_pending() == 0), "attach() discards latched edges");
+        check(gateway.enabled(BUTTON_SOURCE) && gateway.enabled(ENCODER_SOURCE) &&
+              (gateway.priority(BUTTON_SOURCE) == driver::default_gpio_irq_config::PRIORITY), "attach() enables the PLIC source");
+
+        // Both pins latch an edge, the button rise edge is not enabled and pin 5 is not attached.
+        edges.rise(5);
+        edges.fall(BUTTON);
+        edges.rise(BUTTON);
+        edges.rise(ENCODER);
+        edges.fall(ENCODER);
+        plic.dispatch();
+        check(pressed == 2, "the fall handler is called for each latched edge");
+        check(encoder == 2, "the handler of both edges is called for each edge");
+        check((edges.fall_pending() == 0) && (edges.rise_pending() == (1U << 5)),
+              "the handlers clear only the edges of their pin");
+        check((gateway.claims.size() == 3) && (gateway.claims[0] == BUTTON_SOURCE) &&
+              (gateway.claims[1] == BUTTON_SOURCE) && (gateway.claims[2] == ENCODER_SOURCE), "pin sources claimed");
+        check(gateway.completes == gateway.claims, "pin sources completed");
+
+        gpio_irq.detach<BUTTON>();
+        edges.fall(BUTTON);
+        plic.dispatch();
+        check((pressed == 2) && !gateway.enabled(BUTTON_SOURCE), "detach() stops the interrupts of the pin");
+        gpio_irq.detach<ENCODER>();
+    }
+
+    /** use_pll() only changes the PLL while it is deselected, and selects it after the lock delay. */
+    void test_prci_use_pll(void) {
+        namespace prci_param = mmio_param::sifive_fe310_g000_prci;
+        using pllcfg_r = prci_param::pllcfg_r;
+        using plloutdiv_r = prci_param::plloutdiv_r;
+        auto &regs = mmio_sim::register_file::instance();
+        constexpr std::uintptr_t PLLCFG_ADDR = SIFIVE_FE310_G000_PRCI + pllcfg_r::offset;
+        constexpr std::uint32_t DIVISORS = pllcfg_r::pllr_f::bit_mask | pllcfg_r::pllf_f::bit_mask | pllcfg_r::pllq_f::bit_mask |
+            pllcfg_r::pllrefsel_f::bit_mask | pllcfg_r::pllbypass_f::bit_mask;
+        sim_mtime mtime(MTIME_START);
+        mtime.tick_on_read(true);
+        sim_timer mtimer;
+        // The oscillators are ready and the PLL is locked when they are read.
+        const auto ready = [&regs] (std::uintptr_t addr, std::uint32_t bit) {
+            regs.on_read(addr, [&regs, bit] (std::uintptr_t addr) {
+                regs.poke<std::uint32_t>(addr, regs.peek<std::uint32_t>(addr) | bit);
+            });
+        };
+        ready(SIFIVE_FE310_G000_PRCI + prci_param::hfrosccfg_r::offset, prci_param::hfrosccfg_r::hfroscrdy_f::bit_mask);
+        ready(SIFIVE_FE310_G000_PRCI + prci_param::hfxosccfg_r::offset, prci_param::hfxosccfg_r::hfxoscrdy_f::bit_mask);
+        ready(PLLCFG_ADDR, pllcfg_r::plllock_f::bit_mask);
+        // Running from the PLL set by the boot loader
+        regs.poke<std::uint32_t>(PLLCFG_ADDR, pllcfg_r::pllsel_f::bit_mask | 0x1);
+        std::uint32_t previous = regs.peek<std::uint32_t>(PLLCFG_ADDR);
+        bool deselected = true;
+        std::uint64_t configured = 0;
+        std::uint64_t selected = 0;
+        regs.on_write(PLLCFG_ADDR, [&] (std::uintptr_t, std::uint64_t value) {
+            if ((previous & pllcfg_r::pllsel_f::bit_mask) && ((previous ^ value) & DIVISORS)) {
+                deselected = false;
+            }
+            if ((previous ^ value) & DIVISORS) {
+                configured = mtime.now();
+            }
+            if (!(previous & pllcfg_r::pllsel_f::bit_mask) && (value & pllcfg_r::pllsel_f::bit_mask)) {
+                selected = mtime.now();
+            }
+            previous = static_cast<std::uint32_t>(value);
+        });
+
+        sim_prci prci;
+        prci.use_pll<pll_320mhz>(mtimer);
+        const std::uint32_t pllcfg = regs.peek<std::uint32_t>(PLLCFG_ADDR);
+        check(deselected, "the PLL is deselected while it is configured");
+        check((pllcfg & pllcfg_r::pllsel_f::bit_mask) != 0, "the PLL is selected");
+        check((pllcfg & pllcfg_r::pllr_f::bit_mask) == (2 - 1), "pllr: R=2");
+        check(((pllcfg & pllcfg_r::pllf_f::bit_mask) >> pllcfg_r::pllf_f::bit_offset) == (80/2 - 1), "pllf: F=80");
+        check(((pllcfg & pllcfg_r::pllq_f::bit_mask) >> pllcfg_r::pllq_f::bit_offset) == 1, "pllq: Q=2");
+        check((pllcfg & (pllcfg_r::pllrefsel_f::bit_mask | pllcfg_r::pllbypass_f::bit_mask)) == pllcfg_r::pllrefsel_f::bit_mask,
+              "the PLL reference is the crystal, not bypassed");
+        check((regs.peek<std::uint32_t>(SIFIVE_FE310_G000_PRCI + plloutdiv_r::offset) & plloutdiv_r::divby1_f::bit_mask) != 0,
+              "no output divider");
+        constexpr std::uint64_t LOCK_TICKS = (sim_prci::PLL_LOCK_DELAY_US * driver::default_timer_config::MTIME_FREQ_HZ) / 1000000;
+        check((configured != 0) && (selected - configured > LOCK_TICKS), "the PLL is selected after the lock delay");
+    }
+
+    /** The rxwm interrupt drains the receive FIFO into the receive buffer, in order. */
+    void test_uart_rx(void) {
+        sim_uart_fifo fifo;
+        sim_uart uart(115200);
+        check(fifo.ie() == uart_param::ie_r::rxwm_f::bit_mask, "rxwm enabled, txwm disabled");
+        std::uint8_t next = 0;
+        for (unsigned int i = 0; i < sim_uart_fifo::FIFO_DEPTH; i++) {
+            fifo.receive(next++);
+        }
+        uart.handle_interrupt();
+        check(fifo.rx.empty(), "rxwm drains the receive FIFO");
+        check(uart.rx_available() == sim_uart_fifo::FIFO_DEPTH, "received bytes are buffered");
+        // Fill the receive buffer, further bytes are dropped and counted.
+        while (next < 160) {
+            for (unsigned int i = 0; i < sim_uart_fifo::FIFO_DEPTH; i++) {
+                fifo.receive(next++);
+            }
+            uart.handle_interrupt();
+        }
+        check(uart.rx_available() == driver::default_uart_config::RX_BUFFER_SIZE, "receive buffer full");
+        check(uart.rx_overruns() == 160 - driver::default_uart_config::RX_BUFFER_SIZE, "receive overruns counted");
+        std::uint8_t data[160] = {};
+        const std::size_t count = uart.read(data, sizeof(data));
+        bool in_order = count == driver::default_uart_config::RX_BUFFER_SIZE;
+        for (std::size_t i = 0; in_order && (i < count); i++) {
+            in_order = data[i] == i;
+        }
+        check(in_order, "received bytes are read in order");
+        check(fifo.tx.empty(), "nothing transmitted by the receive interrupt");
+    }
+
+    /** The txwm interrupt refills the transmit FIFO in one burst, and is disabled when the buffer is empty. */
+    void test_uart_tx(void) {
+        using ie_r = uart_param::ie_r;
+        sim_uart_fifo fifo;
+        sim_uart uart(115200);
+        constexpr std::string_view text = "The txwm interrupt refills the transmit FIFO\r\n";
+        check(uart.write(text) == text.size(), "write() queues the text");
+        check((fifo.ie() & ie_r::txwm_f::bit_mask) != 0, "write() enables txwm");
+        check(fifo.tx.empty(), "write() does not touch the transmit FIFO");
+
+        unsigned int interrupts = 0;
+        bool full_bursts = true;
+        // Shift out bytes until txwm is pending, as the interrupt would be taken.
+        while ((fifo.ie() & ie_r::txwm_f::bit_mask) != 0) {
+            while (fifo.tx.size() >= driver::default_uart_config::TX_WATERMARK) {
+                fifo.transmit();
+            }
+            const std::size_t queued = text.size() - fifo.line.size() - fifo.tx.size();
+            const std::size_t level = fifo.tx.size();
+            uart.handle_interrupt();
+            // The burst is all remaining data, or fills the FIFO.
+            const std::size_t expected = (queued < sim_uart::TX_BURST) ? queued : sim_uart::TX_BURST;
+            full_bursts = full_bursts && (fifo.tx.size() - level == expected);
+            interrupts++;
+        }
+        while (fifo.transmit()) {
+        }
+        check(fifo.line == text, "transmitted in order");
+        check(fifo.tx_overflows == 0, "the burst does not overflow the transmit FIFO");
+        check(full_bursts, "each interrupt writes a full burst");
+        check(interrupts == (text.size() + sim_uart::TX_BURST - 1) / sim_uart::TX_BURST, "one interrupt for each burst");
+        check((fifo.ie() & ie_r::rxwm_f::bit_mask) != 0, "rxwm stays enabled");
+
+        // txwm stays pending with an empty FIFO, e.g. seen by an rxwm interrupt, but stays disabled.
+        uart.handle_interrupt();
+        check(fifo.tx.empty() && ((fifo.ie() & ie_r::txwm_f::bit_mask) == 0), "no data written with an empty transmit buffer");
+        check(uart.write("x") == 1, "write() after the buffer is empty");
+        check((fifo.ie() & ie_r::txwm_f::bit_mask) != 0, "write() re-enables txwm");
+        uart.handle_interrupt();
+        check((fifo.tx.size() == 1) && (fifo.ie() & ie_r::txwm_f::bit_mask) == 0, "txwm disabled after the last byte");
+    }
+
+    /** Single producer, single consumer ring buffer across the index wrap. */
+    void test_ring_buffer(void) {
+        irq::ring_buffer<8> buffer;
+        check(buffer.empty() && (buffer.space() == 8), "empty ring buffer");
+        std::uint8_t value = 0;
+        check(!buffer.pop(value), "pop() from an empty ring buffer");
+        bool in_order = true;
+        std::uint8_t next_in = 0;
+        std::uint8_t next_out = 0;
+        // Partial bulk pushes and pops, so the indexes wrap the storage at every offset.
+        for (unsigned int i = 0; i < 40; i++) {
+            std::uint8_t data[5];
+            for (auto &byte : data) {
+                byte = next_in++;
+            }
+            const std::size_t pushed = buffer.push(data, sizeof(data));
+            next_in -= static_cast<std::uint8_t>(sizeof(data) - pushed);
+            std::uint8_t out[3];
+            const std::size_t popped = buffer.pop(out, sizeof(out));
+            for (std::size_t j = 0; j < popped; j++) {
+                in_order = in_order && (out[j] == next_out++);
+            }
+        }
+        check(in_order, "ring buffer data in order across the wrap");
+        // Full before the last pop of 3
+        check(buffer.size() == 5, "ring buffer fills when pushed faster than popped");
+        while (buffer.push(next_in)) {
+            next_in++;
+        }
+        check(buffer.size() == 8, "push() to a full ring buffer");
+        check(buffer.push(&value, 1) == 0, "bulk push() to a full ring buffer");
+        while (buffer.pop(value)) {
+            in_order = in_order && (value == next_out++);
+        }
+        check(in_order && (next_out == next_in), "ring buffer drains in order");
+        check(buffer.empty() && (buffer.space() == 8), "ring buffer empty after draining");
+    }
+
+    /** Deferred work is executed in order, and the queue rejects work when full. */
+    void test_work_queue(void) {
+        irq::work_queue<4> queue;
+        struct work_log {
+            unsigned int executed[8] = {};
+            unsigned int count = 0;
+            void record(unsigned int id) {
+                executed[count++ & 7] = id;
+            }
+        } log;
+        check(queue.empty() && (queue.drain() == 0), "empty work queue");
+        for (unsigned int i = 0; i < 4; i++) {
+            check(queue.push([&log, i] (void) { log.record(i); }), "push() to the work queue");
+        }
+        check(!queue.push([&log] (void) { log.record(100); }), "push() to a full work queue");
+        check(queue.drain() == 4, "drain() executes all work");
+        check((log.count == 4) && (log.executed[0] == 0) && (log.executed[1] == 1) &&
+              (log.executed[2] == 2) && (log.executed[3] == 3), "work executed in order");
+        check(queue.empty(), "work queue empty after drain()");
+
+        // Work queued by work, e.g. an interrupt taken while draining, runs in the same drain().
+        check(queue.push([&queue, &log] (void) {
+                log.record(10);
+                queue.push([&log] (void) { log.record(20); });
+            }), "push() work that queues work");
+        check(queue.drain() == 2, "drain() executes work queued while draining");
+        check((log.count == 6) && (log.executed[4] == 10) && (log.executed[5] == 20), "queued work executed after its producer");
+        // The slots are reused across the index wrap
+        for (unsigned int i = 0; i < 10; i++) {
+            queue.push([&log] (void) { log.record(30); });
+            queue.push([&log] (void) { log.record(30); });
+            queue.drain();
+        }
+        check(log.count == 26, "work queue slots reused");
+    }
+
+    /** Assigning a field writes it, value() only formats the operand of modify(). */
+    void test_reg_field(void) {
+        auto &regs = mmio_sim::register_file::instance();
+        driver::sifive_uart0_0_dev<SIFIVE_UART0_0, mmio_sim::sim_access> uart_dev;
+        uart_dev.txctrl.write(uart_param::txctrl_r::txen_f::bit_mask);
+        const std::size_t writes = regs.writes();
+        const auto txcnt = uart_dev.txctrl.txcnt.value(5);
+        check((regs.writes() == writes) && (uart_dev.txctrl.read() == uart_param::txctrl_r::txen_f::bit_mask),
+              "value() does not write");
+        check(txcnt.value == (5U << uart_param::txctrl_r::txcnt_f::bit_offset), "value() formats the field");
+        uart_dev.txctrl.txcnt = 3;
+        check(uart_dev.txctrl.read() == (uart_param::txctrl_r::txen_f::bit_mask | (3U << uart_param::txctrl_r::txcnt_f::bit_offset)),
+              "assignment writes the field");
+        uart_dev.txctrl.modify(txcnt, uart_dev.txctrl.nstop.value(true));
+        check(uart_dev.txctrl.read() == (uart_param::txctrl_r::txen_f::bit_mask | uart_param::txctrl_r::nstop_f::bit_mask |
+                                         (5U << uart_param::txctrl_r::txcnt_f::bit_offset)),
+              "modify() writes the fields");
+    }
+
+    /** Pin configuration keeps the configuration of the other pins. */
+    void test_gpio(void) {
+        auto &regs = mmio_sim::register_file::instance();
+        constexpr std::uint32_t UART0_PINS = (1U << 16) | (1U << 17);
+        // Set by the boot loader
+        regs.poke<std::uint32_t>(SIFIVE_GPIO0_0 + mmio_param::sifive_gpio0_0::iof_en_r::offset, UART0_PINS);
+        sim_gpio gpio;
+        driver::pin_group<sim_gpio, 19, 21, 22> leds(gpio);
+        leds.iof<1>();
+        check(gpio.iof_en.read() == (UART0_PINS | leds.MASK), "iof<1>() keeps the UART0 pins");
+        check(gpio.iof_sel.read() == leds.MASK, "iof<1>() selects IOF1");
+        leds.output();
+        check(gpio.iof_en.read() == UART0_PINS, "output() keeps the UART0 pins");
+        check(gpio.output_en.read() == leds.MASK, "output() enables the outputs");
+        leds.set();
+        check(gpio.output_val.read() == leds.MASK, "set()");
+        leds.toggle();
+        check(gpio.output_val.read() == 0, "toggle()");
+        leds.write(1U << 21);
+        check(gpio.output_val.read() == (1U << 21), "write()");
+        leds.clear();
+        check(gpio.output_val.read() == 0, "clear()");
+    }
+}
+
+int main(void) {
+    auto &regs = mmio_sim::register_file::instance();
+    for (auto test : { test_timer_read, test_timer_cmp, test_timer_wheel, test_timer_wheel_restart, test_gpio,
+                        test_plic_dispatch, test_gpio_irq, test_prci_use_pll,
+                        test_reg_field, test_uart_rx, test_uart_tx, test_ring_buffer, test_work_queue }) {
+        regs.reset();
+        test();
+    }
+    return host_test::result((__riscv_xlen == 64) ? "sim_drivers (RV64)" : "sim_drivers (RV32)");
+}
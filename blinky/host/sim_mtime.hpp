@@ -0,0 +1,53 @@
+/*
+   Simulated machine timer for the host test programs.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+*/
+
+#ifndef HOST_SIM_MTIME_HPP
+#define HOST_SIM_MTIME_HPP
+
+#include <cstdint>
+
+#include "mmio_sim.hpp"
+#include "timer.hpp"
+
+namespace host_test {
+
+    /** Simulated mtime, the hardware side of the timer registers. */
+    class sim_mtime {
+    public:
+        static constexpr std::uintptr_t MTIME_ADDR = driver::mtimer_address_spec::MTIME_ADDR;
+
+        explicit sim_mtime(std::uint64_t start)
+            : _now(start) {
+            auto &regs = mmio_sim::register_file::instance();
+            regs.on_read(MTIME_ADDR, [this] (std::uintptr_t) { load(); });
+            regs.on_read(MTIME_ADDR + 4, [this] (std::uintptr_t) { load(); });
+        }
+        std::uint64_t now(void) const {
+            return _now;
+        }
+        void advance(std::uint64_t ticks) {
+            _now += ticks;
+        }
+        /** Advance by one tick on each bus read, so the counter moves between the reads of a 64 bit value. */
+        void tick_on_read(bool enable) {
+            _tick_on_read = enable;
+        }
+    private:
+        std::uint64_t _now;
+        bool _tick_on_read = false;
+
+        void load(void) {
+            if (_tick_on_read) {
+                _now++;
+            }
+            mmio_sim::register_file::instance().poke<std::uint64_t>(MTIME_ADDR, _now);
+        }
+    };
+}
+
+#endif // #ifndef HOST_SIM_MTIME_HPP
@@ -0,0 +1,248 @@
+/*
+   Host tests of the trap instruction decode and emulation.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   The trapping instructions are encoded in host memory, and the misaligned
+   accesses use host buffers, so this is built at the host register width.
+   Returns non-zero if a check fails.
+
+*/
+
+#include <cstdint>
+#include <cstring>
+
+#include "trap_emulation.hpp"
+
+#include "check.hpp"
+
+using host_test::check;
+using irq::uint_xlen_t;
+
+namespace {
+
+    // Base instruction formats
+    constexpr std::uint32_t encode_r(unsigned int opcode, unsigned int rd, unsigned int funct3,
+                                     unsigned int rs1, unsigned int rs2, unsigned int funct7) {
+        return (funct7 << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+    }
+    constexpr std::uint32_t encode_i(unsigned int opcode, unsigned int rd, unsigned int funct3,
+                                     unsigned int rs1, std::int32_t imm) {
+        return ((static_cast<std::uint32_t>(imm) & 0xFFF) << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+    }
+    constexpr std::uint32_t encode_s(unsigned int opcode, unsigned int funct3,
+                                     unsigned int rs1, unsigned int rs2, std::int32_t imm) {
+        const std::uint32_t u = static_cast<std::uint32_t>(imm);
+        return (((u >> 5) & 0x7F) << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | ((u & 0x1F) << 7) | opcode;
+    }
+    constexpr std::uint32_t encode_amo(unsigned int funct5, unsigned int rd, unsigned int rs1, unsigned int rs2) {
+        return encode_r(irq::instruction::OPCODE_AMO, rd, 0x2, rs1, rs2, funct5 << 2);
+    }
+    // Compressed formats, rd'/rs1'/rs2' are x8 to x15
+    constexpr std::uint32_t encode_c_lw(unsigned int funct3, unsigned int rs1, unsigned int rs2, unsigned int offset) {
+        return (funct3 << 13) | (((offset >> 3) & 0x7) << 10) | ((rs1 - 8) << 7)
+            | (((offset >> 2) & 0x1) << 6) | (((offset >> 6) & 0x1) << 5) | ((rs2 - 8) << 2);
+    }
+    constexpr std::uint32_t encode_c_lwsp(unsigned int rd, unsigned int offset) {
+        return (0x2 << 13) | (((offset >> 5) & 0x1) << 12) | (rd << 7)
+            | (((offset >> 2) & 0x7) << 4) | (((offset >> 6) & 0x3) << 2) | 0x2;
+    }
+    constexpr std::uint32_t encode_c_swsp(unsigned int rs2, unsigned int offset) {
+        return (0x6 << 13) | (((offset >> 2) & 0xF) << 9) | (((offset >> 6) & 0x3) << 7) | (rs2 << 2) | 0x2;
+    }
+
+    /** A trapping instruction in host memory, and the frame of the trapping context. */
+    struct trap {
+        explicit trap(std::uint32_t bits) {
+            code[0] = static_cast<std::uint16_t>(bits);
+            code[1] = static_cast<std::uint16_t>(bits >> 16);
+            std::memset(&frame, 0, sizeof(frame));
+            frame.mepc = reinterpret_cast<uint_xlen_t>(&code[0]);
+        }
+        uint_xlen_t pc(void) const {
+            return reinterpret_cast<uint_xlen_t>(&code[0]);
+        }
+        std::uint16_t code[2];
+        irq::trap_frame frame;
+    };
+
+    template<class T> bool not_emulated(T const &handler, std::uint32_t bits) {
+        trap t(bits);
+        t.frame.x[10] = 0x1001;
+        irq::trap_frame before = t.frame;
+        return !handler.emulate(t.frame) && (std::memcmp(&before, &t.frame, sizeof(before)) == 0);
+    }
+
+    void test_decode(void) {
+        trap addi(encode_i(0x13, 1, 0, 2, -1));
+        irq::instruction insn(addi.pc());
+        check(insn.length == 4, "32 bit instruction length");
+        check((insn.rd() == 1) && (insn.rs1() == 2), "I-type registers");
+        check(insn.imm_i() == ~static_cast<uint_xlen_t>(0), "imm_i sign extension");
+
+        trap store(encode_s(irq::instruction::OPCODE_STORE, 2, 3, 4, -2048));
+        irq::instruction s(store.pc());
+        check(s.imm_s() == static_cast<uint_xlen_t>(-2048), "imm_s sign extension");
+        check((s.rs1() == 3) && (s.rs2() == 4) && (s.funct3() == 2), "S-type fields");
+        trap store_pos(encode_s(irq::instruction::OPCODE_STORE, 2, 3, 4, 0x7E5));
+        check(irq::instruction(store_pos.pc()).imm_s() == 0x7E5, "imm_s split immediate");
+
+        trap c_lw(encode_c_lw(irq::instruction::C_FUNCT3_LW, 9, 10, 124));
+        irq::instruction cl(c_lw.pc());
+        check(cl.length == 2, "compressed instruction length");
+        check((cl.c_rs1_short() == 9) && (cl.c_rs2_short() == 10), "CL registers");
+        check(cl.c_lw_offset() == 124, "c.lw offset");
+        check(irq::instruction(trap(encode_c_lw(irq::instruction::C_FUNCT3_LW, 8, 8, 64)).pc()).c_lw_offset() == 64,
+              "c.lw offset bit 6");
+        trap c_lwsp(encode_c_lwsp(5, 252));
+        irq::instruction clsp(c_lwsp.pc());
+        check((clsp.c_rd() == 5) && (clsp.c_lwsp_offset() == 252), "c.lwsp offset");
+        trap c_swsp(encode_c_swsp(7, 252));
+        irq::instruction cssp(c_swsp.pc());
+        check((cssp.c_rs2() == 7) && (cssp.c_swsp_offset() == 252), "c.swsp offset");
+    }
+
+    void test_misaligned_load(void) {
+        const irq::misaligned_load_emulation load;
+        alignas(8) std::uint8_t data[16] = {
+            0x00, 0x80, 0x81, 0x82, 0x83, 0x7F, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A };
+        const uint_xlen_t base = reinterpret_cast<uint_xlen_t>(&data[0]);
+        struct {
+            unsigned int funct3;
+            uint_xlen_t expected;
+            const char *what;
+        } const loads[] = {
+            { 0, static_cast<uint_xlen_t>(-0x80), "lb sign extension" },
+            { 4, 0x80, "lbu zero extension" },
+            { 1, static_cast<uint_xlen_t>(static_cast<std::int16_t>(0x8180)), "lh sign extension" },
+            { 5, 0x8180, "lhu zero extension" },
+            { 2, static_cast<uint_xlen_t>(static_cast<std::int32_t>(0x83828180)), "lw sign extension" },
+        };
+        for (auto const &l : loads) {
+            trap t(encode_i(irq::instruction::OPCODE_LOAD, 11, l.funct3, 12, 2));
+            t.frame.x[12] = base - 1;
+            check(load.emulate(t.frame), l.what);
+            check(t.frame.x[11] == l.expected, l.what);
+            check(t.frame.mepc == t.pc() + 4, "mepc advanced past the load");
+        }
+        if constexpr (sizeof(uint_xlen_t) == 8) {
+            trap lwu(encode_i(irq::instruction::OPCODE_LOAD, 11, 6, 12, 1));
+            lwu.frame.x[12] = base;
+            check(load.emulate(lwu.frame) && (lwu.frame.x[11] == 0x83828180), "lwu zero extension");
+        }
+        // Positive values are not sign extended
+        trap lh(encode_i(irq::instruction::OPCODE_LOAD, 11, 1, 12, 5));
+        lh.frame.x[12] = base;
+        check(load.emulate(lh.frame) && (lh.frame.x[11] == 0x017F), "lh of a positive value");
+        // x0 is not written
+        trap to_x0(encode_i(irq::instruction::OPCODE_LOAD, 0, 2, 12, 1));
+        to_x0.frame.x[12] = base;
+        check(load.emulate(to_x0.frame) && (to_x0.frame.x[0] == 0), "load to x0 is discarded");
+
+        trap c_lw(encode_c_lw(irq::instruction::C_FUNCT3_LW, 9, 10, 4));
+        c_lw.frame.x[9] = base - 3;
+        check(load.emulate(c_lw.frame), "c.lw emulated");
+        check(c_lw.frame.x[10] == static_cast<uint_xlen_t>(static_cast<std::int32_t>(0x83828180)), "c.lw value");
+        check(c_lw.frame.mepc == c_lw.pc() + 2, "mepc advanced past c.lw");
+        trap c_lwsp(encode_c_lwsp(5, 8));
+        c_lwsp.frame.x[2] = base - 3;
+        check(load.emulate(c_lwsp.frame) && (c_lwsp.frame.x[5] == 0x0302017F), "c.lwsp value");
+
+        check(not_emulated(load, encode_i(0x13, 1, 0, 2, 4)), "addi is not an emulated load");
+        check(not_emulated(load, encode_c_lw(irq::instruction::C_FUNCT3_SW, 9, 10, 4)), "c.sw is not an emulated load");
+        check(not_emulated(load, 0x0001), "c.nop is not an emulated load");
+    }
+
+    void test_misaligned_store(void) {
+        const irq::misaligned_store_emulation store;
+        alignas(8) std::uint8_t data[16] = {};
+        const uint_xlen_t base = reinterpret_cast<uint_xlen_t>(&data[0]);
+        trap sw(encode_s(irq::instruction::OPCODE_STORE, 2, 12, 13, -3));
+        sw.frame.x[12] = base + 4;
+        sw.frame.x[13] = 0xA1B2C3D4;
+        check(store.emulate(sw.frame), "sw emulated");
+        check((data[1] == 0xD4) && (data[2] == 0xC3) && (data[3] == 0xB2) && (data[4] == 0xA1), "sw bytes");
+        check((data[0] == 0) && (data[5] == 0), "sw writes 4 bytes");
+        check(sw.frame.mepc == sw.pc() + 4, "mepc advanced past the store");
+
+        std::memset(data, 0, sizeof(data));
+        trap sh(encode_s(irq::instruction::OPCODE_STORE, 1, 12, 13, 7));
+        sh.frame.x[12] = base;
+        sh.frame.x[13] = 0xA1B2C3D4;
+        check(store.emulate(sh.frame) && (data[7] == 0xD4) && (data[8] == 0xC3) && (data[9] == 0), "sh bytes");
+
+        std::memset(data, 0, sizeof(data));
+        trap c_sw(encode_c_lw(irq::instruction::C_FUNCT3_SW, 9, 10, 4));
+        c_sw.frame.x[9] = base - 1;
+        c_sw.frame.x[10] = 0x11223344;
+        check(store.emulate(c_sw.frame) && (data[3] == 0x44) && (data[6] == 0x11), "c.sw bytes");
+        check(c_sw.frame.mepc == c_sw.pc() + 2, "mepc advanced past c.sw");
+
+        std::memset(data, 0, sizeof(data));
+        trap c_swsp(encode_c_swsp(7, 8));
+        c_swsp.frame.x[2] = base - 7;
+        c_swsp.frame.x[7] = 0x11223344;
+        check(store.emulate(c_swsp.frame) && (data[1] == 0x44) && (data[4] == 0x11), "c.swsp bytes");
+
+        check(not_emulated(store, encode_i(irq::instruction::OPCODE_LOAD, 1, 2, 2, 0)), "lw is not an emulated store");
+        check(not_emulated(store, encode_c_lwsp(5, 8)), "c.lwsp is not an emulated store");
+    }
+
+    void test_illegal_instruction(void) {
+        const irq::illegal_instruction_emulation emulation;
+        auto muldiv = [&] (unsigned int funct3, uint_xlen_t a, uint_xlen_t b) {
+            trap t(encode_r(irq::instruction::OPCODE_OP, 10, funct3, 11, 12, irq::instruction::FUNCT7_MULDIV));
+            t.frame.x[11] = a;
+            t.frame.x[12] = b;
+            const bool emulated = emulation.emulate(t.frame) && (t.frame.mepc == t.pc() + 4);
+            return emulated ? t.frame.x[10] : 0xDEAD;
+        };
+        const uint_xlen_t minus_one = ~static_cast<uint_xlen_t>(0);
+        const uint_xlen_t int_min = static_cast<uint_xlen_t>(1) << (sizeof(uint_xlen_t) * 8 - 1);
+        check(muldiv(0, 7, static_cast<uint_xlen_t>(-3)) == static_cast<uint_xlen_t>(-21), "mul");
+        check(muldiv(1, minus_one, minus_one) == 0, "mulh -1 * -1");
+        check(muldiv(3, minus_one, minus_one) == minus_one - 1, "mulhu");
+        check(muldiv(2, minus_one, 2) == minus_one, "mulhsu");
+        check(muldiv(4, static_cast<uint_xlen_t>(-7), 2) == static_cast<uint_xlen_t>(-3), "div rounds toward zero");
+        check(muldiv(4, 5, 0) == minus_one, "div by zero");
+        check(muldiv(4, int_min, minus_one) == int_min, "div overflow");
+        check(muldiv(5, 7, 0) == minus_one, "divu by zero");
+        check(muldiv(6, static_cast<uint_xlen_t>(-7), 2) == minus_one, "rem sign");
+        check(muldiv(6, int_min, minus_one) == 0, "rem overflow");
+        check(muldiv(7, 7, 0) == 7, "remu by zero");
+
+        alignas(4) std::uint32_t word = 0x80000001;
+        const uint_xlen_t address = reinterpret_cast<uint_xlen_t>(&word);
+        auto amo = [&] (unsigned int funct5, uint_xlen_t source) {
+            trap t(encode_amo(funct5, 10, 11, 12));
+            t.frame.x[11] = address;
+            t.frame.x[12] = source;
+            const bool emulated = emulation.emulate(t.frame) && (t.frame.mepc == t.pc() + 4);
+            return emulated ? t.frame.x[10] : 0xDEAD;
+        };
+        check(amo(0x00, 1) == static_cast<uint_xlen_t>(static_cast<std::int32_t>(0x80000001)), "amoadd.w result sign extended");
+        check(word == 0x80000002, "amoadd.w");
+        check((amo(0x10, 5) == static_cast<uint_xlen_t>(static_cast<std::int32_t>(0x80000002))) && (word == 0x80000002), "amomin.w signed");
+        check((amo(0x18, 5) != 0xDEAD) && (word == 5), "amominu.w");
+        check((amo(0x02, 0) == 5) && (amo(0x03, 9) == 0) && (word == 9), "lr.w and sc.w");
+        check((amo(0x03, 3) == 1) && (word == 9), "sc.w without a reservation fails");
+
+        check(not_emulated(emulation, encode_amo(0x1F, 10, 11, 12)), "unknown AMO is not emulated");
+        check(not_emulated(emulation, encode_r(irq::instruction::OPCODE_OP, 1, 0, 2, 3, 0x20)), "sub is not emulated");
+        check(not_emulated(emulation, 0x0001), "compressed instructions are not emulated");
+        {
+            trap t(encode_amo(0x00, 10, 11, 12));
+            t.frame.x[11] = address + 1;
+            check(!emulation.emulate(t.frame), "misaligned AMO is not emulated");
+        }
+    }
+}
+
+int main(void) {
+    test_decode();
+    test_misaligned_load();
+    test_misaligned_store();
+    test_illegal_instruction();
+    return host_test::result("sim_trap");
+}
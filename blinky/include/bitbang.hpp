@@ -0,0 +1,467 @@
+/*
+   Bit-banged serial engines on the sifive_gpio0_0 device.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   SPI master, I2C master and UART transmitter on any GPIO pins.
+
+   - Edges are paced by the mcycle counter against absolute deadlines, so
+     loop overhead does not accumulate and the bit rate is cycle accurate.
+   - The bit loops are placed in the .itim section, copied to the instruction
+     tightly integrated memory at startup, so fetch time is deterministic.
+     The loops are members of the non-template engines (spi_engine, i2c_engine,
+     uart_tx_engine), which take the GPIO registers and pin masks at run
+     time, see the .itim rule in src/linker.lds. The templates only configure
+     the pins. The loops are flattened, so they make no calls to code in flash.
+   - With a shadowed output_val each edge is a single store (see gpio.hpp).
+
+   The timing is given in core clock cycles per bit, e.g. from driver::cycle_clock:
+
+       using hires_clock = driver::cycle_clock<decltype(mtimer)>;
+       driver::spi_master<decltype(gpio_dev), SCK, MOSI, MISO> spi(gpio_dev,
+           driver::cycles_per_bit(hires_clock::core_clock(), 1000000));
+       std::uint8_t rx = spi.transfer(0x9F);
+
+*/
+
+#ifndef BITBANG_HPP
+#define BITBANG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__riscv)
+// RISC-V CSR definitions and access classes
+#include "riscv-csr.hpp"
+#endif
+
+// MMIO register access policies
+#include "mmio_device.hpp"
+
+// Critical sections
+#include "critical_section.hpp"
+
+// Typed GPIO pins
+#include "gpio.hpp"
+
+namespace driver {
+
+    /** Core clock cycles per bit for a bit rate. */
+    constexpr std::uint32_t cycles_per_bit(std::uint32_t core_clock_hz, std::uint32_t bit_rate) {
+        return (core_clock_hz + bit_rate/2) / bit_rate;
+    }
+    /** Core clock cycles per bit for a bit rate, at the nominal core clock of a clock configuration. */
+    template<class CLOCK> constexpr std::uint32_t cycles_per_bit(std::uint32_t bit_rate) {
+        return cycles_per_bit(CLOCK::CORE_CLOCK_HZ, bit_rate);
+    }
+
+    /** Deadline pacing on the low word of mcycle. */
+    class cycle_pacer {
+    public:
+        inline cycle_pacer(void) __attribute__((always_inline))
+            : _deadline(now()) {}
+
+        /** Advance the deadline and wait for it. */
+        inline void wait(std::uint32_t cycles) __attribute__((always_inline)) {
+            _deadline += cycles;
+            // Signed difference handles the counter wrapping.
+            while (static_cast<std::int32_t>(now() - _deadline) < 0) {
+            }
+        }
+        /** Restart the deadlines from the current time. */
+        inline void restart(void) __attribute__((always_inline)) {
+            _deadline = now();
+        }
+#if !defined(__riscv)
+        /** Host build, the cycle counter is modelled by the test program. */
+        static inline std::uint32_t (*host_mcycle)(void) = nullptr;
+#endif
+    private:
+        static inline std::uint32_t now(void) __attribute__((always_inline)) {
+#if defined(__riscv)
+            return static_cast<std::uint32_t>(riscv::csrs.mcycle.read());
+#else
+            return host_mcycle();
+#endif
+        }
+        std::uint32_t _deadline;
+    };
+
+    /** GPIO registers driven by the bit loops, taken from a device at construction.
+        A shadowed register is a single store per edge, otherwise a single AMO.
+     */
+    class bitbang_port {
+    public:
+        /** @param dev   GPIO device, the inputs are read from input_val.
+            @param drive Register driven by the loops, output_val, or output_en for open drain pins.
+         */
+        template<class DEV, class REG> bitbang_port(DEV &dev, REG &drive)
+            : _input(reinterpret_cast<volatile std::uint32_t*>(decltype(DEV::input_val)::address))
+            , _drive(reinterpret_cast<volatile std::uint32_t*>(REG::address))
+            , _shadow(shadow_copy<REG>()) {
+            static_assert(std::is_same_v<typename REG::datatype_t, std::uint32_t>, "The GPIO registers are 32 bit");
+        }
+        /** @param input  Input register.
+            @param drive  Register driven by the loops.
+            @param shadow RAM copy of a shadowed drive register, otherwise nullptr.
+         */
+        bitbang_port(volatile std::uint32_t *input, volatile std::uint32_t *drive, std::uint32_t *shadow)
+            : _input(input)
+            , _drive(drive)
+            , _shadow(shadow) {}
+
+        /** Set the drive bits of mask */
+        inline void set(std::uint32_t mask) const __attribute__((always_inline)) {
+            if (_shadow) {
+                *_shadow |= mask;
+                *_drive = *_shadow;
+            } else {
+                modify<mmio_device::atomic_op::or_bits>(mask);
+            }
+        }
+        /** Clear the drive bits of mask */
+        inline void clear(std::uint32_t mask) const __attribute__((always_inline)) {
+            if (_shadow) {
+                *_shadow &= ~mask;
+                *_drive = *_shadow;
+            } else {
+                modify<mmio_device::atomic_op::and_bits>(~mask);
+            }
+        }
+        inline void write(std::uint32_t mask, bool value) const __attribute__((always_inline)) {
+            if (value) {
+                set(mask);
+            } else {
+                clear(mask);
+            }
+        }
+        /** Test the input of a pin */
+        inline bool test(std::uint32_t mask) const __attribute__((always_inline)) {
+            return (*_input & mask) != 0;
+        }
+    private:
+        volatile std::uint32_t *const _input;
+        volatile std::uint32_t *const _drive;
+        // RAM copy of a shadowed drive register, otherwise nullptr
+        std::uint32_t *const _shadow;
+
+        template<class REG> static std::uint32_t *shadow_copy(void) {
+            if constexpr (REG::access_t::shadowed) {
+                return REG::access_t::copy();
+            } else {
+                return nullptr;
+            }
+        }
+        template<mmio_device::atomic_op OP> __attribute__((always_inline)) inline void modify(std::uint32_t value) const {
+#ifdef __riscv_atomic
+            mmio_device::amo<OP, std::uint32_t>(reinterpret_cast<std::uintptr_t>(_drive), value);
+#else
+            irq::critical_section lock;
+            *_drive = mmio_device::apply<OP>(static_cast<std::uint32_t>(*_drive), value);
+#endif
+        }
+    };
+
+    /** SPI master bit loop, mode 0 (clock idle low, sample on the rising edge), MSB first. */
+    class spi_engine {
+    public:
+        spi_engine(const bitbang_port &port, std::uint32_t sck_mask, std::uint32_t mosi_mask,
+                   std::uint32_t miso_mask, std::uint32_t cycles_per_bit)
+            : _port(port)
+            , _sck(sck_mask)
+            , _mosi(mosi_mask)
+            , _miso(miso_mask)
+            , _half_bit(cycles_per_bit / 2) {}
+
+        /** Transmit and receive one byte. */
+        __attribute__((section(".itim.spi_engine.transfer"), noinline, flatten)) std::uint8_t transfer(std::uint8_t tx) {
+            cycle_pacer pacer;
+            std::uint8_t rx = 0;
+            for (unsigned int bit = 0; bit < 8; bit++) {
+                _port.write(_mosi, tx & 0x80);
+                tx <<= 1;
+                pacer.wait(_half_bit);
+                _port.set(_sck);
+                rx = (rx << 1) | (_port.test(_miso) ? 1 : 0);
+                pacer.wait(_half_bit);
+                _port.clear(_sck);
+            }
+            return rx;
+        }
+    private:
+        const bitbang_port _port;
+        const std::uint32_t _sck;
+        const std::uint32_t _mosi;
+        const std::uint32_t _miso;
+        const std::uint32_t _half_bit;
+    };
+
+    /** SPI master, mode 0 (clock idle low, sample on the rising edge), MSB first.
+        Chip select is not handled, use a driver::pin.
+     */
+    template<class DEV, unsigned int SCK, unsigned int MOSI, unsigned int MISO> class spi_master {
+    public:
+        spi_master(DEV &dev, std::uint32_t cycles_per_bit)
+            : _sck(dev)
+            , _mosi(dev)
+            , _miso(dev)
+            , _engine(bitbang_port(dev, dev.output_val),
+                      util::bitmask(SCK), util::bitmask(MOSI), util::bitmask(MISO), cycles_per_bit) {
+            _sck.clear();
+            _sck.output();
+            _mosi.output();
+            _miso.input();
+        }
+        // Boilerplate delete defaults - non copyable class
+        spi_master(const spi_master&) = delete;
+        spi_master &operator=(const spi_master&) = delete;
+        spi_master(spi_master&&) = delete;
+        spi_master &operator=(spi_master&&) = delete;
+
+        /** Transmit and receive one byte. */
+        std::uint8_t transfer(std::uint8_t tx) {
+            return _engine.transfer(tx);
+        }
+        /** Transmit and receive a buffer. rx may be nullptr to discard the received data. */
+        void transfer(const std::uint8_t *tx, std::uint8_t *rx, std::size_t length) {
+            for (std::size_t i = 0; i < length; i++) {
+                std::uint8_t value = _engine.transfer(tx[i]);
+                if (rx) {
+                    rx[i] = value;
+                }
+            }
+        }
+    private:
+        pin<DEV, SCK> _sck;
+        pin<DEV, MOSI> _mosi;
+        pin<DEV, MISO> _miso;
+        spi_engine _engine;
+    };
+
+    /** I2C master bit loops. The port drives output_en, a set bit pulls the pin low.
+        The slave may stretch the clock.
+     */
+    class i2c_engine {
+    public:
+        /** Maximum number of half bit periods the slave may stretch the clock */
+        static constexpr unsigned int STRETCH_LIMIT = 1000;
+
+        i2c_engine(const bitbang_port &port, std::uint32_t scl_mask, std::uint32_t sda_mask,
+                   std::uint32_t cycles_per_bit)
+            : _port(port)
+            , _scl(scl_mask)
+            , _sda(sda_mask)
+            , _half_bit(cycles_per_bit / 2) {}
+
+        /** Start condition, SDA falls while SCL is high. Also used for a repeated start. */
+        __attribute__((section(".itim.i2c_engine.start"), noinline, flatten)) bool start(void) {
+            cycle_pacer pacer;
+            _port.clear(_sda);
+            pacer.wait(_half_bit);
+            if (!release_scl(pacer)) {
+                return false;
+            }
+            _port.set(_sda);
+            pacer.wait(_half_bit);
+            _port.set(_scl);
+            return true;
+        }
+        /** Stop condition, SDA rises while SCL is high. */
+        __attribute__((section(".itim.i2c_engine.stop"), noinline, flatten)) void stop(void) {
+            cycle_pacer pacer;
+            _port.set(_sda);
+            pacer.wait(_half_bit);
+            release_scl(pacer);
+            pacer.wait(_half_bit);
+            _port.clear(_sda);
+            pacer.wait(_half_bit);
+        }
+        /** Write a byte.
+            @retval true The slave acknowledged the byte.
+         */
+        __attribute__((section(".itim.i2c_engine.write"), noinline, flatten)) bool write(std::uint8_t value) {
+            cycle_pacer pacer;
+            for (unsigned int bit = 0; bit < 8; bit++) {
+                // Release SDA for a 1, pull low for a 0
+                _port.write(_sda, !(value & 0x80));
+                value <<= 1;
+                pacer.wait(_half_bit);
+                if (!release_scl(pacer)) {
+                    return false;
+                }
+                pacer.wait(_half_bit);
+                _port.set(_scl);
+            }
+            // Acknowledge, the slave pulls SDA low
+            _port.clear(_sda);
+            pacer.wait(_half_bit);
+            if (!release_scl(pacer)) {
+                return false;
+            }
+            const bool ack = !_port.test(_sda);
+            pacer.wait(_half_bit);
+            _port.set(_scl);
+            return ack;
+        }
+        /** Read a byte.
+            @param ack Acknowledge the byte, false for the last byte of a read.
+         */
+        __attribute__((section(".itim.i2c_engine.read"), noinline, flatten)) std::uint8_t read(bool ack) {
+            cycle_pacer pacer;
+            std::uint8_t value = 0;
+            _port.clear(_sda);
+            for (unsigned int bit = 0; bit < 8; bit++) {
+                pacer.wait(_half_bit);
+                if (!release_scl(pacer)) {
+                    return value;
+                }
+                value = (value << 1) | (_port.test(_sda) ? 1 : 0);
+                pacer.wait(_half_bit);
+                _port.set(_scl);
+            }
+            if (ack) {
+                _port.set(_sda);
+            }
+            pacer.wait(_half_bit);
+            release_scl(pacer);
+            pacer.wait(_half_bit);
+            _port.set(_scl);
+            _port.clear(_sda);
+            return value;
+        }
+    private:
+        const bitbang_port _port;
+        const std::uint32_t _scl;
+        const std::uint32_t _sda;
+        const std::uint32_t _half_bit;
+
+        /** Release SCL and wait for it to go high, the slave may be stretching the clock.
+            @retval false The clock was held low for STRETCH_LIMIT half bit periods.
+         */
+        inline bool release_scl(cycle_pacer &pacer) __attribute__((always_inline)) {
+            _port.clear(_scl);
+            for (unsigned int i = 0; i < STRETCH_LIMIT; i++) {
+                if (_port.test(_scl)) {
+                    pacer.restart();
+                    return true;
+                }
+                pacer.wait(_half_bit);
+            }
+            return false;
+        }
+    };
+
+    /** I2C master. The pins are open drain: driven low by enabling the output (output_val is 0),
+        released high by disabling the output. The internal pull-ups are enabled.
+        The slave may stretch the clock.
+     */
+    template<class DEV, unsigned int SCL, unsigned int SDA> class i2c_master {
+    public:
+        static constexpr std::uint32_t SCL_MASK = util::bitmask(SCL);
+        static constexpr std::uint32_t SDA_MASK = util::bitmask(SDA);
+        /** Maximum number of half bit periods the slave may stretch the clock */
+        static constexpr unsigned int STRETCH_LIMIT = i2c_engine::STRETCH_LIMIT;
+
+        i2c_master(DEV &dev, std::uint32_t cycles_per_bit)
+            : _dev(dev)
+            , _engine(bitbang_port(dev, dev.output_en), SCL_MASK, SDA_MASK, cycles_per_bit) {
+            _dev.output_en &= ~(SCL_MASK | SDA_MASK);
+            _dev.iof_en &= ~(SCL_MASK | SDA_MASK);
+            _dev.output_val &= ~(SCL_MASK | SDA_MASK);
+            _dev.pue |= (SCL_MASK | SDA_MASK);
+            _dev.input_en |= (SCL_MASK | SDA_MASK);
+        }
+        // Boilerplate delete defaults - non copyable class
+        i2c_master(const i2c_master&) = delete;
+        i2c_master &operator=(const i2c_master&) = delete;
+        i2c_master(i2c_master&&) = delete;
+        i2c_master &operator=(i2c_master&&) = delete;
+
+        /** Start condition, SDA falls while SCL is high. Also used for a repeated start. */
+        bool start(void) {
+            return _engine.start();
+        }
+        /** Stop condition, SDA rises while SCL is high. */
+        void stop(void) {
+            _engine.stop();
+        }
+        /** Write a byte.
+            @retval true The slave acknowledged the byte.
+         */
+        bool write(std::uint8_t value) {
+            return _engine.write(value);
+        }
+        /** Read a byte.
+            @param ack Acknowledge the byte, false for the last byte of a read.
+         */
+        std::uint8_t read(bool ack) {
+            return _engine.read(ack);
+        }
+    private:
+        DEV &_dev;
+        i2c_engine _engine;
+    };
+
+    /** UART transmitter bit loop, 8 data bits, no parity, 1 stop bit. LSB first. */
+    class uart_tx_engine {
+    public:
+        uart_tx_engine(const bitbang_port &port, std::uint32_t tx_mask, std::uint32_t cycles_per_bit)
+            : _port(port)
+            , _tx(tx_mask)
+            , _bit(cycles_per_bit) {}
+
+        /** Send one byte. Interrupts should be disabled to keep the bit timing. */
+        __attribute__((section(".itim.uart_tx_engine.write"), noinline, flatten)) void write(std::uint8_t value) {
+            cycle_pacer pacer;
+            // Start bit, 8 data bits, stop bit
+            std::uint32_t frame = (static_cast<std::uint32_t>(value) << 1) | (1UL << 9);
+            for (unsigned int bit = 0; bit < 10; bit++) {
+                _port.write(_tx, frame & 1);
+                frame >>= 1;
+                pacer.wait(_bit);
+            }
+        }
+    private:
+        const bitbang_port _port;
+        const std::uint32_t _tx;
+        const std::uint32_t _bit;
+    };
+
+    /** UART transmitter, 8 data bits, no parity, 1 stop bit. LSB first.
+        Interrupts are disabled while each byte is sent to keep the bit timing.
+     */
+    template<class DEV, unsigned int TX> class uart_tx {
+    public:
+        uart_tx(DEV &dev, std::uint32_t cycles_per_bit)
+            : _tx(dev)
+            , _engine(bitbang_port(dev, dev.output_val), util::bitmask(TX), cycles_per_bit) {
+            // Idle high
+            _tx.set();
+            _tx.output();
+        }
+        // Boilerplate delete defaults - non copyable class
+        uart_tx(const uart_tx&) = delete;
+        uart_tx &operator=(const uart_tx&) = delete;
+        uart_tx(uart_tx&&) = delete;
+        uart_tx &operator=(uart_tx&&) = delete;
+
+        /** Send one byte. */
+        void write(std::uint8_t value) {
+            irq::critical_section lock;
+            _engine.write(value);
+        }
+        /** Send a buffer. */
+        void write(const std::uint8_t *data, std::size_t length) {
+            for (std::size_t i = 0; i < length; i++) {
+                write(data[i]);
+            }
+        }
+    private:
+        pin<DEV, TX> _tx;
+        uart_tx_engine _engine;
+    };
+}
+
+#endif // #ifndef BITBANG_HPP
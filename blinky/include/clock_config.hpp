@@ -0,0 +1,41 @@
+/*
+   Clock tree configuration.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   A single type describes the board clocks. The driver configurations
+   (timer, cycle_clock, uart, pwm) derive from it, so the baud rate, PWM
+   and delay calculations follow the core clock set by driver::prci.
+
+   e.g.
+       using clock_config = driver::pll_clock_config<320000000>;
+       driver::uart<UART0_ADDR, driver::uart_config<clock_config>> uart(115200);
+
+*/
+
+#ifndef CLOCK_CONFIG_HPP
+#define CLOCK_CONFIG_HPP
+
+#include <cstdint>
+
+namespace driver {
+
+    /** SiFive-hifive1-revb clocks
+     */
+    struct default_clock_config {
+        // See
+        // freedom-e-sdk/bsp/sifive-hifive1-revb/core.dts
+        // hfxosc: 16MHz crystal
+        static constexpr std::uint32_t HFXOSC_HZ=16000000;
+        // hfclk, the core clock and tlclk (peripheral bus clock), from the hfxosc
+        static constexpr std::uint32_t CORE_CLOCK_HZ=16000000;
+        // FE310-G002 datasheet, maximum core clock.
+        static constexpr std::uint32_t MAX_CORE_CLOCK_HZ=320000000;
+        // psdlfaltclk: clock@6
+        // Fixed to 32Khz
+        static constexpr unsigned int MTIME_FREQ_HZ=32768;
+    };
+}
+
+#endif // #ifndef CLOCK_CONFIG_HPP
@@ -0,0 +1,236 @@
+/*
+   C++20 coroutine tasks scheduled by the timer wheel.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Sequential tasks without an RTOS and without a stack per task.
+   Coroutine frames are allocated from a static pool, not the heap.
+   A sleeping coroutine is a software timer on the timer wheel, the timer
+   interrupt queues the coroutine on the deferred work queue, and the idle
+   loop resumes it.
+
+   Requires C++20 coroutine support (-std=c++20), the rest of the project is C++17.
+
+   e.g.
+       driver::timer_wheel<decltype(mtimer)> wheel(mtimer);
+       irq::work_queue<8> ready;
+       coro::scheduler sched(wheel, ready);
+
+       static coro::task<> blink(decltype(sched) &sched, gpio_dev_t &gpio_dev) {
+           while (true) {
+               gpio_dev.output_val ^= LED_MASK_WHITE;
+               co_await sched.sleep(std::chrono::milliseconds{500});
+           }
+       }
+
+       sched.spawn(blink(sched, gpio_dev));
+       // Idle loop
+       do {
+           ready.drain();
+           wheel.idle([&] { return !ready.empty(); });
+       } while (true);
+
+*/
+
+#ifndef COROUTINE_HPP
+#define COROUTINE_HPP
+
+#if !defined(__cpp_impl_coroutine)
+#error "coroutine.hpp requires C++20 coroutines, e.g. -std=c++20"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+// Critical sections
+#include "critical_section.hpp"
+
+// Software timers
+#include "timer_wheel.hpp"
+
+namespace coro {
+
+    /** Fixed size pool of coroutine frames.
+        @tparam FRAMES     Number of frames, at most 32.
+        @tparam FRAME_SIZE Bytes for each frame. The frame size is only known to the compiler,
+                           a coroutine with a larger frame fails to allocate.
+     */
+    template<std::size_t FRAMES, std::size_t FRAME_SIZE> class frame_pool {
+    public:
+        static_assert(FRAMES > 0 && FRAMES <= 32, "The frame pool free bitmap is 32 bits");
+
+        /** Allocate a frame.
+            @retval nullptr The pool is exhausted or the frame is too large.
+         */
+        void *allocate(std::size_t size) {
+            if (size > FRAME_SIZE) {
+                return nullptr;
+            }
+            irq::critical_section lock;
+            if (_free == 0) {
+                return nullptr;
+            }
+            const unsigned int index = __builtin_ctz(_free);
+            _free &= ~(1UL << index);
+            return _frames[index];
+        }
+        /** Return a frame to the pool. */
+        void deallocate(void *frame) {
+            const std::size_t index = (static_cast<unsigned char *>(frame) - _frames[0]) / FRAME_SIZE;
+            irq::critical_section lock;
+            _free |= (1UL << index);
+        }
+    private:
+        alignas(std::max_align_t) unsigned char _frames[FRAMES][FRAME_SIZE];
+        std::uint32_t _free = (FRAMES == 32) ? UINT32_MAX : ((1UL << FRAMES) - 1);
+    };
+
+    /** Coroutine task. The return type of a coroutine.
+        The task is created suspended, and is started by scheduler::spawn().
+        The frame is released to the pool when the coroutine completes.
+        @tparam FRAMES     Number of frames in the static pool shared by all tasks of this type.
+        @tparam FRAME_SIZE Bytes for each frame.
+     */
+    template<std::size_t FRAMES=4, std::size_t FRAME_SIZE=256> class task {
+    public:
+        struct promise_type {
+            static void *operator new(std::size_t size) noexcept {
+                return _pool.allocate(size);
+            }
+            static void operator delete(void *frame) {
+                _pool.deallocate(frame);
+            }
+            /** Called if the pool could not allocate the frame */
+            static task get_return_object_on_allocation_failure(void) {
+                return task(nullptr);
+            }
+            task get_return_object(void) {
+                return task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend(void) noexcept { return {}; }
+            std::suspend_never final_suspend(void) noexcept { return {}; }
+            void return_void(void) {}
+            // Exceptions are disabled.
+            void unhandled_exception(void) {
+                __builtin_trap();
+            }
+        };
+
+        explicit task(std::coroutine_handle<promise_type> handle)
+            : _handle(handle) {}
+        task(task &&other)
+            : _handle(other.release()) {}
+        ~task() {
+            // A task that was never spawned.
+            if (_handle) {
+                _handle.destroy();
+            }
+        }
+        // Boilerplate delete defaults - move only class
+        task(const task&) = delete;
+        task &operator=(const task&) = delete;
+        task &operator=(task&&) = delete;
+
+        /** Check the frame was allocated. */
+        bool valid(void) const {
+            return static_cast<bool>(_handle);
+        }
+        /** Release ownership of the coroutine, it now owns its own frame. */
+        std::coroutine_handle<> release(void) {
+            auto handle = _handle;
+            _handle = nullptr;
+            return handle;
+        }
+    private:
+        std::coroutine_handle<promise_type> _handle;
+        static inline frame_pool<FRAMES, FRAME_SIZE> _pool;
+    };
+
+    /** Single core executor for coroutine tasks.
+        Coroutines are resumed from the deferred work queue drained by the idle loop,
+        never from interrupt context. Sleeps are software timers on the timer wheel.
+        @tparam WHEEL driver::timer_wheel type.
+        @tparam QUEUE irq::work_queue type, executed by the idle loop.
+     */
+    template<class WHEEL, class QUEUE> class scheduler {
+    public:
+        scheduler(WHEEL &wheel, QUEUE &ready)
+            : _wheel(wheel)
+            , _ready(ready) {}
+        // Boilerplate delete defaults - non copyable class
+        scheduler(const scheduler&) = delete;
+        scheduler &operator=(const scheduler&) = delete;
+        scheduler(scheduler&&) = delete;
+        scheduler &operator=(scheduler&&) = delete;
+
+        /** Awaitable that suspends a coroutine for a std::chrono::duration.
+            The timer node is held in the coroutine frame, no allocation is needed.
+         */
+        class sleep_awaitable {
+        public:
+            sleep_awaitable(scheduler &sched, std::uint64_t ticks)
+                : _sched(sched)
+                , _ticks(ticks)
+                , _timer(*this) {}
+
+            bool await_ready(void) const {
+                return _ticks == 0;
+            }
+            void await_suspend(std::coroutine_handle<> handle) {
+                _handle = handle;
+                _sched._wheel.start_raw(_timer, _ticks, 0);
+            }
+            void await_resume(void) const {}
+
+            /** Timer expiry, called from the timer interrupt. */
+            void operator()(void) const {
+                if (!_sched.schedule(_handle)) {
+                    // The ready queue is full, retry on the next timer tick.
+                    _sched._wheel.start_raw(_timer, 1, 0);
+                }
+            }
+        private:
+            scheduler &_sched;
+            const std::uint64_t _ticks;
+            std::coroutine_handle<> _handle;
+            // Mutable as the timer is restarted from the const expiry callback.
+            mutable driver::timer_node _timer;
+        };
+
+        /** Suspend the calling coroutine for a duration: co_await sched.sleep(10ms) */
+        template<class T=std::chrono::microseconds> sleep_awaitable sleep(T duration) {
+            const auto ticks = std::chrono::duration_cast<typename WHEEL::timer_ticks>(duration).count();
+            return sleep_awaitable(*this, (ticks > 0) ? ticks : 0);
+        }
+
+        /** Start a task. It runs from the idle loop up to its first suspension.
+            @retval false The task frame was not allocated, or the ready queue is full.
+         */
+        template<class TASK> bool spawn(TASK &&new_task) {
+            if (!new_task.valid()) {
+                return false;
+            }
+            auto handle = new_task.release();
+            if (!schedule(handle)) {
+                handle.destroy();
+                return false;
+            }
+            return true;
+        }
+
+        /** Queue a coroutine to be resumed by the idle loop. */
+        bool schedule(std::coroutine_handle<> handle) {
+            return _ready.push([handle] (void)
+                {
+                    handle.resume();
+                });
+        }
+    private:
+        WHEEL &_wheel;
+        QUEUE &_ready;
+    };
+}
+
+#endif // #ifndef COROUTINE_HPP
@@ -0,0 +1,57 @@
+/*
+   Machine mode critical sections for RISC-V.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+*/
+
+#ifndef CRITICAL_SECTION_HPP
+#define CRITICAL_SECTION_HPP
+
+#if defined(__riscv)
+// RISC-V CSR definitions and access classes
+#include "riscv-csr.hpp"
+#endif
+
+namespace irq {
+
+#if defined(__riscv)
+    /** Disable machine mode interrupts for the lifetime of this object.
+        The previous state of mstatus.MIE is restored on destruction.
+     */
+    class critical_section {
+    public:
+        // Always inlined, so code placed in the ITIM makes no calls to flash.
+        inline critical_section(void) __attribute__((always_inline))
+            : _mstatus(riscv::csrs.mstatus.read_clr_bits_const<riscv::csr::mstatus_data::mie::BIT_MASK>()) {}
+        inline ~critical_section() __attribute__((always_inline)) {
+            if (_mstatus & riscv::csr::mstatus_data::mie::BIT_MASK) {
+                riscv::csrs.mstatus.set_const<riscv::csr::mstatus_data::mie::BIT_MASK>();
+            }
+        }
+        // Boilerplate delete defaults - non copyable class
+        critical_section(const critical_section&) = delete;
+        critical_section &operator=(const critical_section&) = delete;
+        critical_section(critical_section&&) = delete;
+        critical_section &operator=(critical_section&&) = delete;
+    private:
+        const riscv::csr::uint_xlen_t _mstatus;
+    };
+#else
+    /** Host build, e.g. the simulated MMIO of mmio_sim.hpp.
+        There are no interrupts to disable.
+     */
+    class critical_section {
+    public:
+        critical_section(void) {}
+        // Boilerplate delete defaults - non copyable class
+        critical_section(const critical_section&) = delete;
+        critical_section &operator=(const critical_section&) = delete;
+        critical_section(critical_section&&) = delete;
+        critical_section &operator=(critical_section&&) = delete;
+    };
+#endif
+}
+
+#endif // #ifndef CRITICAL_SECTION_HPP
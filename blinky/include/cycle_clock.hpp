@@ -0,0 +1,191 @@
+/*
+   High resolution clock for RISC-V using the mcycle counter.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   The mtime counter is accurate but coarse (~30us at 32768Hz), the mcycle
+   counter has core clock resolution but an uncertain frequency. The mcycle
+   frequency is calibrated against mtime at boot.
+
+   The calibration also aligns mtime ticks to mcycle counts, so an mtime
+   deadline (e.g. mtimecmp) can be converted to the mcycle count at which it
+   occurs. sync() re-aligns the counters to bound the drift between the two
+   oscillators.
+
+   e.g.
+       using hires_clock = driver::cycle_clock<decltype(mtimer)>;
+       hires_clock::calibrate(mtimer);
+       auto start = hires_clock::now();
+       hot_loop();
+       auto elapsed = hires_clock::now() - start;
+
+*/
+
+#ifndef CYCLE_CLOCK_HPP
+#define CYCLE_CLOCK_HPP
+
+#include <cstdint>
+#include <chrono>
+
+// RISC-V CSR definitions and access classes
+#include "riscv-csr.hpp"
+
+// Critical sections
+#include "critical_section.hpp"
+
+// Clock tree configuration
+#include "clock_config.hpp"
+
+namespace driver {
+
+    /** Core clock parameters.
+        CLOCK::CORE_CLOCK_HZ is the nominal core clock, used until the clock is calibrated.
+        @tparam CLOCK Clock configuration, e.g. driver::pll_clock_config<>.
+     */
+    template<class CLOCK=default_clock_config> struct cycle_clock_config : CLOCK {
+        // Calibration time in mtime ticks, ~10ms at 32768Hz
+        static constexpr std::uint32_t CALIBRATION_TICKS=328;
+    };
+    /** SiFive-hifive1-revb core clock parameters
+     */
+    using default_cycle_clock_config = cycle_clock_config<>;
+
+    /** std::chrono clock of the mcycle counter with nanosecond durations.
+        Meets the requirements of a C++ Clock. The epoch is the reset of the mcycle counter.
+        @tparam TIMER  driver::timer type used to calibrate the core clock frequency.
+        @tparam CONFIG Nominal core clock frequency and calibration time.
+     */
+    template<class TIMER, class CONFIG=default_cycle_clock_config> struct cycle_clock {
+        using rep = std::int64_t;
+        using period = std::nano;
+        using duration = std::chrono::duration<rep, period>;
+        using time_point = std::chrono::time_point<cycle_clock>;
+        static constexpr bool is_steady = true;
+
+        static time_point now(void) noexcept {
+            return time_point(to_duration(cycles()));
+        }
+
+        /** Read the raw 64 bit mcycle counter */
+        static std::uint64_t cycles(void) {
+            if constexpr ( __riscv_xlen == 64) {
+                return riscv::csrs.mcycle.read();
+            } else {
+                std::uint32_t mcycleh_val;
+                std::uint32_t mcycle_val;
+                do {
+                    // Same as mtime, mcycleh may tick over after reading mcycle
+                    mcycleh_val = riscv::csrs.mcycleh.read();
+                    mcycle_val = riscv::csrs.mcycle.read();
+                } while (mcycleh_val != riscv::csrs.mcycleh.read());
+                return (static_cast<std::uint64_t>(mcycleh_val)<<32)|mcycle_val;
+            }
+        }
+
+        /** Convert a count of core clock cycles to a duration in nanoseconds.
+            Uses a 32.32 fixed point nanoseconds per cycle factor, no division is needed.
+         */
+        static duration to_duration(std::uint64_t cycle_count) {
+            const std::uint64_t factor = _ns_per_cycle;
+            const std::uint64_t factor_h = factor >> 32;
+            const std::uint64_t factor_l = factor & 0xFFFFFFFFUL;
+            const std::uint64_t cycles_h = cycle_count >> 32;
+            const std::uint64_t cycles_l = cycle_count & 0xFFFFFFFFUL;
+            // (cycle_count * factor) >> 32 without a 128 bit product
+            return duration(static_cast<rep>(cycle_count * factor_h
+                                             + cycles_h * factor_l
+                                             + ((cycles_l * factor_l) >> 32)));
+        }
+
+        /** Measure the core clock frequency against the mtime counter.
+            Interrupts are disabled for CONFIG::CALIBRATION_TICKS mtime ticks.
+            @retval The measured core clock frequency in Hz.
+         */
+        static std::uint32_t calibrate(TIMER &timer) {
+            using mtime_period = typename TIMER::clock::period;
+            irq::critical_section lock;
+            // Start on an mtime tick edge
+            const std::uint32_t first_tick = timer.get_raw_time_short();
+            std::uint32_t start_tick;
+            do {
+                start_tick = timer.get_raw_time_short();
+            } while (start_tick == first_tick);
+            const std::uint64_t start_cycles = cycles();
+            while ((timer.get_raw_time_short() - start_tick) < CONFIG::CALIBRATION_TICKS) {
+            }
+            const std::uint64_t end_cycles = cycles();
+            align(start_tick + CONFIG::CALIBRATION_TICKS, end_cycles, end_cycles - start_cycles, CONFIG::CALIBRATION_TICKS);
+            const std::uint64_t core_clock_hz = ((end_cycles - start_cycles) * mtime_period::den)
+                / (static_cast<std::uint64_t>(CONFIG::CALIBRATION_TICKS) * mtime_period::num);
+            set_core_clock(static_cast<std::uint32_t>(core_clock_hz));
+            return _core_clock_hz;
+        }
+
+        /** Re-align mtime ticks to mcycle counts on an mtime tick edge, and refine the
+            cycles per tick over the time since the previous alignment.
+            Interrupts are disabled for up to one mtime tick.
+            Call at least every few seconds if tick_cycles() is used, e.g. from the idle loop.
+         */
+        static void sync(TIMER &timer) {
+            irq::critical_section lock;
+            const std::uint32_t first_tick = timer.get_raw_time_short();
+            std::uint32_t tick;
+            do {
+                tick = timer.get_raw_time_short();
+            } while (tick == first_tick);
+            const std::uint64_t now_cycles = cycles();
+            const std::uint32_t ticks = tick - _anchor_tick;
+            if (ticks >= CONFIG::CALIBRATION_TICKS) {
+                align(tick, now_cycles, now_cycles - _anchor_cycles, ticks);
+            } else {
+                _anchor_tick = tick;
+                _anchor_cycles = now_cycles;
+            }
+        }
+
+        /** The mcycle count at the start of an mtime tick.
+            @param tick Low word of mtime, within 2^31 ticks of the last calibrate() or sync().
+         */
+        static std::uint64_t tick_cycles(std::uint32_t tick) {
+            const std::int32_t ticks = static_cast<std::int32_t>(tick - _anchor_tick);
+            const std::uint64_t distance = (ticks < 0) ? (0 - static_cast<std::uint64_t>(static_cast<std::int64_t>(ticks)))
+                                                       : static_cast<std::uint64_t>(ticks);
+            // distance * _cycles_per_tick (32.32 fixed point), distance is less than 2^31
+            const std::uint64_t offset = distance * (_cycles_per_tick >> 32)
+                + ((distance * (_cycles_per_tick & 0xFFFFFFFFUL)) >> 32);
+            return (ticks < 0) ? (_anchor_cycles - offset) : (_anchor_cycles + offset);
+        }
+
+        /** Set the core clock frequency, e.g. after changing the PLL */
+        static void set_core_clock(std::uint32_t core_clock_hz) {
+            _core_clock_hz = core_clock_hz;
+            _ns_per_cycle = ns_per_cycle(core_clock_hz);
+        }
+
+        /** The calibrated, or nominal, core clock frequency in Hz */
+        static std::uint32_t core_clock(void) {
+            return _core_clock_hz;
+        }
+
+    private:
+        static constexpr std::uint64_t ns_per_cycle(std::uint32_t core_clock_hz) {
+            return (static_cast<std::uint64_t>(std::nano::den) << 32) / core_clock_hz;
+        }
+        /** Save an mtime tick edge and mcycle count pair, and the 32.32 fixed point cycles per tick. */
+        static void align(std::uint32_t tick, std::uint64_t tick_cycles, std::uint64_t elapsed_cycles, std::uint32_t elapsed_ticks) {
+            _anchor_tick = tick;
+            _anchor_cycles = tick_cycles;
+            _cycles_per_tick = ((elapsed_cycles / elapsed_ticks) << 32)
+                + (((elapsed_cycles % elapsed_ticks) << 32) / elapsed_ticks);
+        }
+        static inline std::uint32_t _core_clock_hz = CONFIG::CORE_CLOCK_HZ;
+        static inline std::uint64_t _ns_per_cycle = ns_per_cycle(CONFIG::CORE_CLOCK_HZ);
+        static inline std::uint32_t _anchor_tick = 0;
+        static inline std::uint64_t _anchor_cycles = 0;
+        static inline std::uint64_t _cycles_per_tick =
+            (static_cast<std::uint64_t>(CONFIG::CORE_CLOCK_HZ) << 32) / CONFIG::MTIME_FREQ_HZ;
+    };
+}
+
+#endif // #ifndef CYCLE_CLOCK_HPP
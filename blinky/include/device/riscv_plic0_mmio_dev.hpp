@@ -0,0 +1,39 @@
+/*
+   Register structure definition of peripheral riscv_plic0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef RISCV_PLIC0_MMIO_DEV_HPP
+#define RISCV_PLIC0_MMIO_DEV_HPP
+
+#include <cstdint>
+#include "mmio_device.hpp"
+#include "riscv_plic0_mmio_regs.hpp"
+
+namespace driver {
+
+/*   From riscv,plic0 peripheral, sifive-hifive1-revb core.dts */
+/*   Register arrays are member templates indexed at compile time, e.g. riscv_plic0_dev.priority<1>. */
+template<std::uintptr_t BASE_ADDR,
+         template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class riscv_plic0_dev  {
+public:
+    /* Source priority, indexed by interrupt source ID */
+   template<unsigned int INDEX> static inline mmio_regs::riscv_plic0::priority<BASE_ADDR, ACCESS, INDEX> priority;
+   
+    /* Pending bits, 32 sources per register */
+   template<unsigned int INDEX> static inline mmio_regs::riscv_plic0::pending<BASE_ADDR, ACCESS, INDEX> pending;
+   
+    /* Hart 0 machine mode enable bits, 32 sources per register */
+   template<unsigned int INDEX> static inline mmio_regs::riscv_plic0::enable<BASE_ADDR, ACCESS, INDEX> enable;
+   
+    /* Hart 0 machine mode priority threshold */
+   mmio_regs::riscv_plic0::threshold<BASE_ADDR, ACCESS> threshold;
+   
+    /* Hart 0 machine mode claim/complete */
+   mmio_regs::riscv_plic0::claim<BASE_ADDR, ACCESS> claim;
+   
+}; /* riscv_plic0_dev  */
+
+}
+
+#endif // RISCV_PLIC0_MMIO_DEV_HPP
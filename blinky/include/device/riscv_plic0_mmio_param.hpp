@@ -0,0 +1,58 @@
+/*
+   Register and field offset and size definitions for peripheral riscv_plic0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef RISCV_PLIC0_MMIO_PARAMS_HPP
+#define RISCV_PLIC0_MMIO_PARAMS_HPP
+
+#include <cstdint>
+
+namespace mmio_param {
+    /* From riscv,plic0 peripheral, sifive-hifive1-revb core.dts */
+    namespace riscv_plic0 {
+       /* Source priority, indexed by interrupt source ID */
+       struct priority_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x0;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+           static constexpr unsigned int dim = 53;
+           static constexpr unsigned int dim_increment = 0x4;
+       }; /* priority_r */
+       /* Pending bits, 32 sources per register */
+       struct pending_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x1000;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+           static constexpr unsigned int dim = 2;
+           static constexpr unsigned int dim_increment = 0x4;
+       }; /* pending_r */
+       /* Hart 0 machine mode enable bits, 32 sources per register */
+       struct enable_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x2000;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+           static constexpr unsigned int dim = 2;
+           static constexpr unsigned int dim_increment = 0x4;
+       }; /* enable_r */
+       /* Hart 0 machine mode priority threshold */
+       struct threshold_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x200000;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+       }; /* threshold_r */
+       /* Hart 0 machine mode claim/complete */
+       struct claim_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x200004;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+       }; /* claim_r */
+    }
+}
+
+#endif // RISCV_PLIC0_MMIO_PARAMS_HPP
@@ -0,0 +1,56 @@
+/*
+   Register class and field definition for peripheral riscv_plic0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef RISCV_PLIC0_MMIO_REGS_HPP
+#define RISCV_PLIC0_MMIO_REGS_HPP
+
+#include <cstdint>
+#include "mmio_device.hpp"
+#include "riscv_plic0_mmio_param.hpp"
+
+namespace mmio_regs {
+    /* From riscv,plic0 peripheral, sifive-hifive1-revb core.dts */
+    /* INDEX selects the register of a register array (dim > 1). */
+    namespace riscv_plic0 {
+        /* Source priority, indexed by interrupt source ID */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access,
+                 unsigned int INDEX=0> class priority 
+            : public mmio_device::reg<BASE_ADDR + INDEX*mmio_param::riscv_plic0::priority_r::dim_increment, 
+                                mmio_param::riscv_plic0::priority_r, ACCESS> {
+            static_assert(INDEX < mmio_param::riscv_plic0::priority_r::dim, "Register array index out of range");
+        }; /* priority */
+        /* Pending bits, 32 sources per register */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access,
+                 unsigned int INDEX=0> class pending 
+            : public mmio_device::reg<BASE_ADDR + INDEX*mmio_param::riscv_plic0::pending_r::dim_increment, 
+                                mmio_param::riscv_plic0::pending_r, ACCESS> {
+            static_assert(INDEX < mmio_param::riscv_plic0::pending_r::dim, "Register array index out of range");
+        }; /* pending */
+        /* Hart 0 machine mode enable bits, 32 sources per register */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access,
+                 unsigned int INDEX=0> class enable 
+            : public mmio_device::reg<BASE_ADDR + INDEX*mmio_param::riscv_plic0::enable_r::dim_increment, 
+                                mmio_param::riscv_plic0::enable_r, ACCESS> {
+            static_assert(INDEX < mmio_param::riscv_plic0::enable_r::dim, "Register array index out of range");
+        }; /* enable */
+        /* Hart 0 machine mode priority threshold */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class threshold 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::riscv_plic0::threshold_r, ACCESS> {
+        }; /* threshold */
+        /* Hart 0 machine mode claim/complete */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class claim 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::riscv_plic0::claim_r, ACCESS> {
+        }; /* claim */
+    } /* riscv_plic0 */
+} /* mmio_regs */
+
+#endif // RISCV_PLIC0_MMIO_REGS_HPP
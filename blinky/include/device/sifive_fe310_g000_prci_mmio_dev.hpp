@@ -0,0 +1,35 @@
+/*
+   Register structure definition of peripheral sifive_fe310_g000_prci.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_FE310_G000_PRCI_MMIO_DEV_HPP
+#define SIFIVE_FE310_G000_PRCI_MMIO_DEV_HPP
+
+#include <cstdint>
+#include "mmio_device.hpp"
+#include "sifive_fe310_g000_prci_mmio_regs.hpp"
+
+namespace driver {
+
+/*   From sifive,fe310-g000,prci peripheral generator */
+template<std::uintptr_t BASE_ADDR,
+         template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class sifive_fe310_g000_prci_dev  {
+public:
+    /* Internal oscillator configuration */
+   mmio_regs::sifive_fe310_g000_prci::hfrosccfg<BASE_ADDR, ACCESS> hfrosccfg;
+   
+    /* Crystal oscillator configuration */
+   mmio_regs::sifive_fe310_g000_prci::hfxosccfg<BASE_ADDR, ACCESS> hfxosccfg;
+   
+    /* PLL configuration */
+   mmio_regs::sifive_fe310_g000_prci::pllcfg<BASE_ADDR, ACCESS> pllcfg;
+   
+    /* PLL final divider */
+   mmio_regs::sifive_fe310_g000_prci::plloutdiv<BASE_ADDR, ACCESS> plloutdiv;
+   
+}; /* sifive_fe310_g000_prci_dev  */
+
+}
+
+#endif // SIFIVE_FE310_G000_PRCI_MMIO_DEV_HPP
@@ -0,0 +1,150 @@
+/*
+   Register and field offset and size definitions for peripheral sifive_fe310_g000_prci.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_FE310_G000_PRCI_MMIO_PARAMS_HPP
+#define SIFIVE_FE310_G000_PRCI_MMIO_PARAMS_HPP
+
+#include <cstdint>
+
+namespace mmio_param {
+    /* From sifive,fe310-g000,prci peripheral generator */
+    namespace sifive_fe310_g000_prci {
+       /* Internal oscillator configuration */
+       struct hfrosccfg_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x0;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 4;
+           /* Ring oscillator divider */
+           struct hfroscdiv_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 6;
+               static constexpr std::uint32_t bit_mask = 0x3f;
+           }; /* hfroscdiv_f */
+           /* Ring oscillator trim */
+           struct hfrosctrim_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 16;
+               static constexpr unsigned int bit_width = 5;
+               static constexpr std::uint32_t bit_mask = 0x1f0000;
+           }; /* hfrosctrim_f */
+           /* Ring oscillator enable */
+           struct hfroscen_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 30;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x40000000;
+           }; /* hfroscen_f */
+           /* Ring oscillator ready */
+           struct hfroscrdy_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 31;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x80000000;
+           }; /* hfroscrdy_f */
+       }; /* hfrosccfg_r */
+       /* Crystal oscillator configuration */
+       struct hfxosccfg_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x4;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 2;
+           /* Crystal oscillator enable */
+           struct hfxoscen_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 30;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x40000000;
+           }; /* hfxoscen_f */
+           /* Crystal oscillator ready */
+           struct hfxoscrdy_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 31;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x80000000;
+           }; /* hfxoscrdy_f */
+       }; /* hfxosccfg_r */
+       /* PLL configuration */
+       struct pllcfg_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x8;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 7;
+           /* PLL reference divider, R-1 */
+           struct pllr_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 3;
+               static constexpr std::uint32_t bit_mask = 0x7;
+           }; /* pllr_f */
+           /* PLL multiplier, F/2-1 */
+           struct pllf_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 4;
+               static constexpr unsigned int bit_width = 6;
+               static constexpr std::uint32_t bit_mask = 0x3f0;
+           }; /* pllf_f */
+           /* PLL output divider, log2(Q) */
+           struct pllq_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 10;
+               static constexpr unsigned int bit_width = 2;
+               static constexpr std::uint32_t bit_mask = 0xc00;
+           }; /* pllq_f */
+           /* Select the PLL output as hfclk */
+           struct pllsel_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 16;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x10000;
+           }; /* pllsel_f */
+           /* Select the crystal oscillator as the PLL reference */
+           struct pllrefsel_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 17;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x20000;
+           }; /* pllrefsel_f */
+           /* Bypass the PLL */
+           struct pllbypass_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 18;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x40000;
+           }; /* pllbypass_f */
+           /* PLL locked */
+           struct plllock_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 31;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x80000000;
+           }; /* plllock_f */
+       }; /* pllcfg_r */
+       /* PLL final divider */
+       struct plloutdiv_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0xc;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 2;
+           /* Final divider, 2*(div+1) */
+           struct div_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 6;
+               static constexpr std::uint32_t bit_mask = 0x3f;
+           }; /* div_f */
+           /* Final divider by 1 */
+           struct divby1_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 8;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x100;
+           }; /* divby1_f */
+       }; /* plloutdiv_r */
+    }
+}
+
+#endif // SIFIVE_FE310_G000_PRCI_MMIO_PARAMS_HPP
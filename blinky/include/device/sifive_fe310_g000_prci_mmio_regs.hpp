@@ -0,0 +1,77 @@
+/*
+   Register class and field definition for peripheral sifive_fe310_g000_prci.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_FE310_G000_PRCI_MMIO_REGS_HPP
+#define SIFIVE_FE310_G000_PRCI_MMIO_REGS_HPP
+
+#include <cstdint>
+#include "mmio_device.hpp"
+#include "sifive_fe310_g000_prci_mmio_param.hpp"
+
+namespace mmio_regs {
+    /* From sifive,fe310-g000,prci peripheral generator */
+    namespace sifive_fe310_g000_prci {
+        /* Internal oscillator configuration */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class hfrosccfg 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_fe310_g000_prci::hfrosccfg_r, ACCESS> {
+        public:
+            /* Ring oscillator divider */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::hfrosccfg_r, mmio_param::sifive_fe310_g000_prci::hfrosccfg_r::hfroscdiv_f, ACCESS> hfroscdiv;
+            /* Ring oscillator trim */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::hfrosccfg_r, mmio_param::sifive_fe310_g000_prci::hfrosccfg_r::hfrosctrim_f, ACCESS> hfrosctrim;
+            /* Ring oscillator enable */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::hfrosccfg_r, mmio_param::sifive_fe310_g000_prci::hfrosccfg_r::hfroscen_f, ACCESS> hfroscen;
+            /* Ring oscillator ready */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::hfrosccfg_r, mmio_param::sifive_fe310_g000_prci::hfrosccfg_r::hfroscrdy_f, ACCESS> hfroscrdy;
+        }; /* hfrosccfg */
+        /* Crystal oscillator configuration */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class hfxosccfg 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_fe310_g000_prci::hfxosccfg_r, ACCESS> {
+        public:
+            /* Crystal oscillator enable */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::hfxosccfg_r, mmio_param::sifive_fe310_g000_prci::hfxosccfg_r::hfxoscen_f, ACCESS> hfxoscen;
+            /* Crystal oscillator ready */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::hfxosccfg_r, mmio_param::sifive_fe310_g000_prci::hfxosccfg_r::hfxoscrdy_f, ACCESS> hfxoscrdy;
+        }; /* hfxosccfg */
+        /* PLL configuration */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class pllcfg 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_fe310_g000_prci::pllcfg_r, ACCESS> {
+        public:
+            /* PLL reference divider, R-1 */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::pllcfg_r, mmio_param::sifive_fe310_g000_prci::pllcfg_r::pllr_f, ACCESS> pllr;
+            /* PLL multiplier, F/2-1 */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::pllcfg_r, mmio_param::sifive_fe310_g000_prci::pllcfg_r::pllf_f, ACCESS> pllf;
+            /* PLL output divider, log2(Q) */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::pllcfg_r, mmio_param::sifive_fe310_g000_prci::pllcfg_r::pllq_f, ACCESS> pllq;
+            /* Select the PLL output as hfclk */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::pllcfg_r, mmio_param::sifive_fe310_g000_prci::pllcfg_r::pllsel_f, ACCESS> pllsel;
+            /* Select the crystal oscillator as the PLL reference */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::pllcfg_r, mmio_param::sifive_fe310_g000_prci::pllcfg_r::pllrefsel_f, ACCESS> pllrefsel;
+            /* Bypass the PLL */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::pllcfg_r, mmio_param::sifive_fe310_g000_prci::pllcfg_r::pllbypass_f, ACCESS> pllbypass;
+            /* PLL locked */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::pllcfg_r, mmio_param::sifive_fe310_g000_prci::pllcfg_r::plllock_f, ACCESS> plllock;
+        }; /* pllcfg */
+        /* PLL final divider */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class plloutdiv 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_fe310_g000_prci::plloutdiv_r, ACCESS> {
+        public:
+            /* Final divider, 2*(div+1) */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::plloutdiv_r, mmio_param::sifive_fe310_g000_prci::plloutdiv_r::div_f, ACCESS> div;
+            /* Final divider by 1 */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_fe310_g000_prci::plloutdiv_r, mmio_param::sifive_fe310_g000_prci::plloutdiv_r::divby1_f, ACCESS> divby1;
+        }; /* plloutdiv */
+    } /* sifive_fe310_g000_prci */
+} /* mmio_regs */
+
+#endif // SIFIVE_FE310_G000_PRCI_MMIO_REGS_HPP
@@ -13,61 +13,73 @@
 namespace driver {
 
 /*   From sifive,gpio0,control peripheral generator */
-template<std::uintptr_t BASE_ADDR> class sifive_gpio0_0_dev  {
+/*   SHADOW_ACCESS is the access policy of the write-mostly registers: output_en, output_val, iof_en.
+     Use mmio_device::shadow_access to keep a RAM copy and avoid bus reads on read-modify-write.
+     ACCESS is the access policy of the other registers, e.g. mmio_sim::sim_access on a host. */
+template<std::uintptr_t BASE_ADDR,
+         template<std::uintptr_t, class> class SHADOW_ACCESS=mmio_device::direct_access,
+         template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class sifive_gpio0_0_dev  {
 public:
     /* Pin value */
-   mmio_regs::sifive_gpio0_0::input_val<BASE_ADDR> input_val;
+   mmio_regs::sifive_gpio0_0::input_val<BASE_ADDR, ACCESS> input_val;
    
     /* Pin input enable */
-   mmio_regs::sifive_gpio0_0::input_en<BASE_ADDR> input_en;
+   mmio_regs::sifive_gpio0_0::input_en<BASE_ADDR, ACCESS> input_en;
    
     /* Pin output enable */
-   mmio_regs::sifive_gpio0_0::output_en<BASE_ADDR> output_en;
+   mmio_regs::sifive_gpio0_0::output_en<BASE_ADDR, SHADOW_ACCESS> output_en;
    
     /* Output value */
-   mmio_regs::sifive_gpio0_0::output_val<BASE_ADDR> output_val;
+   mmio_regs::sifive_gpio0_0::output_val<BASE_ADDR, SHADOW_ACCESS> output_val;
    
     /* Internal pull-up enable */
-   mmio_regs::sifive_gpio0_0::pue<BASE_ADDR> pue;
+   mmio_regs::sifive_gpio0_0::pue<BASE_ADDR, ACCESS> pue;
    
     /* Pin drive strength */
-   mmio_regs::sifive_gpio0_0::ds<BASE_ADDR> ds;
+   mmio_regs::sifive_gpio0_0::ds<BASE_ADDR, ACCESS> ds;
    
     /* Rise interrupt enable */
-   mmio_regs::sifive_gpio0_0::rise_ie<BASE_ADDR> rise_ie;
+   mmio_regs::sifive_gpio0_0::rise_ie<BASE_ADDR, ACCESS> rise_ie;
    
     /* Rise interrupt pending */
-   mmio_regs::sifive_gpio0_0::rise_ip<BASE_ADDR> rise_ip;
+   mmio_regs::sifive_gpio0_0::rise_ip<BASE_ADDR, ACCESS> rise_ip;
    
     /* Fall interrupt enable */
-   mmio_regs::sifive_gpio0_0::fall_ie<BASE_ADDR> fall_ie;
+   mmio_regs::sifive_gpio0_0::fall_ie<BASE_ADDR, ACCESS> fall_ie;
    
     /* Fall interrupt pending */
-   mmio_regs::sifive_gpio0_0::fall_ip<BASE_ADDR> fall_ip;
+   mmio_regs::sifive_gpio0_0::fall_ip<BASE_ADDR, ACCESS> fall_ip;
    
     /* High interrupt enable */
-   mmio_regs::sifive_gpio0_0::high_ie<BASE_ADDR> high_ie;
+   mmio_regs::sifive_gpio0_0::high_ie<BASE_ADDR, ACCESS> high_ie;
    
     /* High interrupt pending */
-   mmio_regs::sifive_gpio0_0::high_ip<BASE_ADDR> high_ip;
+   mmio_regs::sifive_gpio0_0::high_ip<BASE_ADDR, ACCESS> high_ip;
    
     /* Low interrupt enable */
-   mmio_regs::sifive_gpio0_0::low_ie<BASE_ADDR> low_ie;
+   mmio_regs::sifive_gpio0_0::low_ie<BASE_ADDR, ACCESS> low_ie;
    
     /* Low interrupt pending */
-   mmio_regs::sifive_gpio0_0::low_ip<BASE_ADDR> low_ip;
+   mmio_regs::sifive_gpio0_0::low_ip<BASE_ADDR, ACCESS> low_ip;
    
     /* I/O function enable */
-   mmio_regs::sifive_gpio0_0::iof_en<BASE_ADDR> iof_en;
+   mmio_regs::sifive_gpio0_0::iof_en<BASE_ADDR, SHADOW_ACCESS> iof_en;
    
     /* I/O function select */
-   mmio_regs::sifive_gpio0_0::iof_sel<BASE_ADDR> iof_sel;
+   mmio_regs::sifive_gpio0_0::iof_sel<BASE_ADDR, ACCESS> iof_sel;
    
     /* Output XOR (invert) */
-   mmio_regs::sifive_gpio0_0::out_xor<BASE_ADDR> out_xor;
+   mmio_regs::sifive_gpio0_0::out_xor<BASE_ADDR, ACCESS> out_xor;
+   
+    /* Load the RAM copies of the SHADOW_ACCESS registers, they may have been written by a boot loader. */
+   sifive_gpio0_0_dev(void) {
+       output_en.sync();
+       output_val.sync();
+       iof_en.sync();
+   }
    
 }; /* sifive_gpio0_0_dev  */
 
 }
 
-#endif // SIFIVE_GPIO0_0_DEV_HPP
+#endif // SIFIVE_GPIO0_0_MMIO_DEV_HPP
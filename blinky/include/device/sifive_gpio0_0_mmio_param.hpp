@@ -133,4 +133,4 @@ namespace mmio_param {
     }
 }
 
-#endif // SIFIVE_GPIO0_0_DEV_HPP
+#endif // SIFIVE_GPIO0_0_MMIO_PARAMS_HPP
@@ -14,91 +14,108 @@ namespace mmio_regs {
     /* From sifive,gpio0,control peripheral generator */
     namespace sifive_gpio0_0 {
         /* Pin value */
-        template<const std::uintptr_t BASE_ADDR> class input_val 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class input_val 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::input_val_r> {
+                                mmio_param::sifive_gpio0_0::input_val_r, ACCESS> {
         }; /* input_val */
         /* Pin input enable */
-        template<const std::uintptr_t BASE_ADDR> class input_en 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class input_en 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::input_en_r> {
+                                mmio_param::sifive_gpio0_0::input_en_r, ACCESS> {
         }; /* input_en */
         /* Pin output enable */
-        template<const std::uintptr_t BASE_ADDR> class output_en 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class output_en 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::output_en_r> {
+                                mmio_param::sifive_gpio0_0::output_en_r, ACCESS> {
         }; /* output_en */
         /* Output value */
-        template<const std::uintptr_t BASE_ADDR> class output_val 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class output_val 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::output_val_r> {
+                                mmio_param::sifive_gpio0_0::output_val_r, ACCESS> {
         }; /* output_val */
         /* Internal pull-up enable */
-        template<const std::uintptr_t BASE_ADDR> class pue 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class pue 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::pue_r> {
+                                mmio_param::sifive_gpio0_0::pue_r, ACCESS> {
         }; /* pue */
         /* Pin drive strength */
-        template<const std::uintptr_t BASE_ADDR> class ds 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class ds 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::ds_r> {
+                                mmio_param::sifive_gpio0_0::ds_r, ACCESS> {
         }; /* ds */
         /* Rise interrupt enable */
-        template<const std::uintptr_t BASE_ADDR> class rise_ie 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class rise_ie 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::rise_ie_r> {
+                                mmio_param::sifive_gpio0_0::rise_ie_r, ACCESS> {
         }; /* rise_ie */
         /* Rise interrupt pending */
-        template<const std::uintptr_t BASE_ADDR> class rise_ip 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class rise_ip 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::rise_ip_r> {
+                                mmio_param::sifive_gpio0_0::rise_ip_r, ACCESS> {
         }; /* rise_ip */
         /* Fall interrupt enable */
-        template<const std::uintptr_t BASE_ADDR> class fall_ie 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class fall_ie 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::fall_ie_r> {
+                                mmio_param::sifive_gpio0_0::fall_ie_r, ACCESS> {
         }; /* fall_ie */
         /* Fall interrupt pending */
-        template<const std::uintptr_t BASE_ADDR> class fall_ip 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class fall_ip 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::fall_ip_r> {
+                                mmio_param::sifive_gpio0_0::fall_ip_r, ACCESS> {
         }; /* fall_ip */
         /* High interrupt enable */
-        template<const std::uintptr_t BASE_ADDR> class high_ie 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class high_ie 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::high_ie_r> {
+                                mmio_param::sifive_gpio0_0::high_ie_r, ACCESS> {
         }; /* high_ie */
         /* High interrupt pending */
-        template<const std::uintptr_t BASE_ADDR> class high_ip 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class high_ip 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::high_ip_r> {
+                                mmio_param::sifive_gpio0_0::high_ip_r, ACCESS> {
         }; /* high_ip */
         /* Low interrupt enable */
-        template<const std::uintptr_t BASE_ADDR> class low_ie 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class low_ie 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::low_ie_r> {
+                                mmio_param::sifive_gpio0_0::low_ie_r, ACCESS> {
         }; /* low_ie */
         /* Low interrupt pending */
-        template<const std::uintptr_t BASE_ADDR> class low_ip 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class low_ip 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::low_ip_r> {
+                                mmio_param::sifive_gpio0_0::low_ip_r, ACCESS> {
         }; /* low_ip */
         /* I/O function enable */
-        template<const std::uintptr_t BASE_ADDR> class iof_en 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class iof_en 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::iof_en_r> {
+                                mmio_param::sifive_gpio0_0::iof_en_r, ACCESS> {
         }; /* iof_en */
         /* I/O function select */
-        template<const std::uintptr_t BASE_ADDR> class iof_sel 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class iof_sel 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::iof_sel_r> {
+                                mmio_param::sifive_gpio0_0::iof_sel_r, ACCESS> {
         }; /* iof_sel */
         /* Output XOR (invert) */
-        template<const std::uintptr_t BASE_ADDR> class out_xor 
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class out_xor 
             : public mmio_device::reg<BASE_ADDR, 
-                                mmio_param::sifive_gpio0_0::out_xor_r> {
+                                mmio_param::sifive_gpio0_0::out_xor_r, ACCESS> {
         }; /* out_xor */
     } /* sifive_gpio0_0 */
 } /* mmio_regs */
 
-#endif // SIFIVE_GPIO0_0_DEV_HPP
\ No newline at end of file
+#endif // SIFIVE_GPIO0_0_MMIO_REGS_HPP
@@ -0,0 +1,36 @@
+/*
+   Register structure definition of peripheral sifive_pwm0_0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_PWM0_0_MMIO_DEV_HPP
+#define SIFIVE_PWM0_0_MMIO_DEV_HPP
+
+#include <cstdint>
+#include "mmio_device.hpp"
+#include "sifive_pwm0_0_mmio_regs.hpp"
+
+namespace driver {
+
+/*   From sifive,pwm0,control peripheral generator */
+/*   Register arrays are member templates indexed at compile time, e.g. sifive_pwm0_0_dev.pwmcmp<1>. */
+template<std::uintptr_t BASE_ADDR,
+         template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class sifive_pwm0_0_dev  {
+public:
+    /* PWM configuration register */
+   mmio_regs::sifive_pwm0_0::pwmcfg<BASE_ADDR, ACCESS> pwmcfg;
+   
+    /* PWM count register */
+   mmio_regs::sifive_pwm0_0::pwmcount<BASE_ADDR, ACCESS> pwmcount;
+   
+    /* Scaled PWM count register */
+   mmio_regs::sifive_pwm0_0::pwms<BASE_ADDR, ACCESS> pwms;
+   
+    /* PWM compare register, indexed by comparator */
+   template<unsigned int INDEX> static inline mmio_regs::sifive_pwm0_0::pwmcmp<BASE_ADDR, ACCESS, INDEX> pwmcmp;
+   
+}; /* sifive_pwm0_0_dev  */
+
+}
+
+#endif // SIFIVE_PWM0_0_MMIO_DEV_HPP
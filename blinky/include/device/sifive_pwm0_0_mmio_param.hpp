@@ -0,0 +1,173 @@
+/*
+   Register and field offset and size definitions for peripheral sifive_pwm0_0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_PWM0_0_MMIO_PARAMS_HPP
+#define SIFIVE_PWM0_0_MMIO_PARAMS_HPP
+
+#include <cstdint>
+
+namespace mmio_param {
+    /* From sifive,pwm0,control peripheral generator */
+    namespace sifive_pwm0_0 {
+       /* PWM configuration register */
+       struct pwmcfg_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x0;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 18;
+           /* Counter scale, pwms is pwmcount shifted right by pwmscale */
+           struct pwmscale_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 4;
+               static constexpr std::uint32_t bit_mask = 0xf;
+           }; /* pwmscale_f */
+           /* Disallow clearing pwmcmpXip bits */
+           struct pwmsticky_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 8;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x100;
+           }; /* pwmsticky_f */
+           /* Reset the counter to zero after a match on pwmcmp0 */
+           struct pwmzerocmp_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 9;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x200;
+           }; /* pwmzerocmp_f */
+           /* Deglitch, latch pwmcmpXip within the same cycle */
+           struct pwmdeglitch_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 10;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x400;
+           }; /* pwmdeglitch_f */
+           /* Enable always, run continuously */
+           struct pwmenalways_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 12;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x1000;
+           }; /* pwmenalways_f */
+           /* Enable one shot, run one cycle */
+           struct pwmenoneshot_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 13;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x2000;
+           }; /* pwmenoneshot_f */
+           /* Comparator 0 center aligned */
+           struct pwmcmp0center_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 16;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x10000;
+           }; /* pwmcmp0center_f */
+           /* Comparator 1 center aligned */
+           struct pwmcmp1center_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 17;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x20000;
+           }; /* pwmcmp1center_f */
+           /* Comparator 2 center aligned */
+           struct pwmcmp2center_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 18;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x40000;
+           }; /* pwmcmp2center_f */
+           /* Comparator 3 center aligned */
+           struct pwmcmp3center_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 19;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x80000;
+           }; /* pwmcmp3center_f */
+           /* Comparator 0/1 gang */
+           struct pwmcmp0gang_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 24;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x1000000;
+           }; /* pwmcmp0gang_f */
+           /* Comparator 1/2 gang */
+           struct pwmcmp1gang_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 25;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x2000000;
+           }; /* pwmcmp1gang_f */
+           /* Comparator 2/3 gang */
+           struct pwmcmp2gang_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 26;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x4000000;
+           }; /* pwmcmp2gang_f */
+           /* Comparator 3/0 gang */
+           struct pwmcmp3gang_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 27;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x8000000;
+           }; /* pwmcmp3gang_f */
+           /* Comparator 0 interrupt pending */
+           struct pwmcmp0ip_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 28;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x10000000;
+           }; /* pwmcmp0ip_f */
+           /* Comparator 1 interrupt pending */
+           struct pwmcmp1ip_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 29;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x20000000;
+           }; /* pwmcmp1ip_f */
+           /* Comparator 2 interrupt pending */
+           struct pwmcmp2ip_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 30;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x40000000;
+           }; /* pwmcmp2ip_f */
+           /* Comparator 3 interrupt pending */
+           struct pwmcmp3ip_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 31;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x80000000;
+           }; /* pwmcmp3ip_f */
+       }; /* pwmcfg_r */
+       /* PWM count register */
+       struct pwmcount_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x8;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+       }; /* pwmcount_r */
+       /* Scaled PWM count register */
+       struct pwms_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x10;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+       }; /* pwms_r */
+       /* PWM compare register, indexed by comparator */
+       struct pwmcmp_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x20;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+           static constexpr unsigned int dim = 4;
+           static constexpr unsigned int dim_increment = 0x4;
+       }; /* pwmcmp_r */
+    }
+}
+
+#endif // SIFIVE_PWM0_0_MMIO_PARAMS_HPP
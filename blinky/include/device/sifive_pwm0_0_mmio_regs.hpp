@@ -0,0 +1,83 @@
+/*
+   Register class and field definition for peripheral sifive_pwm0_0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_PWM0_0_MMIO_REGS_HPP
+#define SIFIVE_PWM0_0_MMIO_REGS_HPP
+
+#include <cstdint>
+#include "mmio_device.hpp"
+#include "sifive_pwm0_0_mmio_param.hpp"
+
+namespace mmio_regs {
+    /* From sifive,pwm0,control peripheral generator */
+    /* INDEX selects the register of a register array (dim > 1). */
+    namespace sifive_pwm0_0 {
+        /* PWM configuration register */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class pwmcfg 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_pwm0_0::pwmcfg_r, ACCESS> {
+        public:
+            /* Counter scale, pwms is pwmcount shifted right by pwmscale */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmscale_f, ACCESS> pwmscale;
+            /* Disallow clearing pwmcmpXip bits */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmsticky_f, ACCESS> pwmsticky;
+            /* Reset the counter to zero after a match on pwmcmp0 */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmzerocmp_f, ACCESS> pwmzerocmp;
+            /* Deglitch, latch pwmcmpXip within the same cycle */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmdeglitch_f, ACCESS> pwmdeglitch;
+            /* Enable always, run continuously */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmenalways_f, ACCESS> pwmenalways;
+            /* Enable one shot, run one cycle */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmenoneshot_f, ACCESS> pwmenoneshot;
+            /* Comparator 0 center aligned */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp0center_f, ACCESS> pwmcmp0center;
+            /* Comparator 1 center aligned */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp1center_f, ACCESS> pwmcmp1center;
+            /* Comparator 2 center aligned */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp2center_f, ACCESS> pwmcmp2center;
+            /* Comparator 3 center aligned */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp3center_f, ACCESS> pwmcmp3center;
+            /* Comparator 0/1 gang */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp0gang_f, ACCESS> pwmcmp0gang;
+            /* Comparator 1/2 gang */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp1gang_f, ACCESS> pwmcmp1gang;
+            /* Comparator 2/3 gang */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp2gang_f, ACCESS> pwmcmp2gang;
+            /* Comparator 3/0 gang */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp3gang_f, ACCESS> pwmcmp3gang;
+            /* Comparator 0 interrupt pending */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp0ip_f, ACCESS> pwmcmp0ip;
+            /* Comparator 1 interrupt pending */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp1ip_f, ACCESS> pwmcmp1ip;
+            /* Comparator 2 interrupt pending */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp2ip_f, ACCESS> pwmcmp2ip;
+            /* Comparator 3 interrupt pending */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_pwm0_0::pwmcfg_r, mmio_param::sifive_pwm0_0::pwmcfg_r::pwmcmp3ip_f, ACCESS> pwmcmp3ip;
+        }; /* pwmcfg */
+        /* PWM count register */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class pwmcount 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_pwm0_0::pwmcount_r, ACCESS> {
+        }; /* pwmcount */
+        /* Scaled PWM count register */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class pwms 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_pwm0_0::pwms_r, ACCESS> {
+        }; /* pwms */
+        /* PWM compare register, indexed by comparator */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access,
+                 unsigned int INDEX=0> class pwmcmp 
+            : public mmio_device::reg<BASE_ADDR + INDEX*mmio_param::sifive_pwm0_0::pwmcmp_r::dim_increment, 
+                                mmio_param::sifive_pwm0_0::pwmcmp_r, ACCESS> {
+            static_assert(INDEX < mmio_param::sifive_pwm0_0::pwmcmp_r::dim, "Register array index out of range");
+        }; /* pwmcmp */
+    } /* sifive_pwm0_0 */
+} /* mmio_regs */
+
+#endif // SIFIVE_PWM0_0_MMIO_REGS_HPP
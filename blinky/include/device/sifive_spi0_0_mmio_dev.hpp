@@ -0,0 +1,71 @@
+/*
+   Register structure definition of peripheral sifive_spi0_0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_SPI0_0_MMIO_DEV_HPP
+#define SIFIVE_SPI0_0_MMIO_DEV_HPP
+
+#include <cstdint>
+#include "mmio_device.hpp"
+#include "sifive_spi0_0_mmio_regs.hpp"
+
+namespace driver {
+
+/*   From sifive,spi0 peripheral generator */
+template<std::uintptr_t BASE_ADDR,
+         template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class sifive_spi0_0_dev  {
+public:
+    /* Serial clock divisor */
+   mmio_regs::sifive_spi0_0::sckdiv<BASE_ADDR, ACCESS> sckdiv;
+   
+    /* Serial clock mode */
+   mmio_regs::sifive_spi0_0::sckmode<BASE_ADDR, ACCESS> sckmode;
+   
+    /* Chip select ID */
+   mmio_regs::sifive_spi0_0::csid<BASE_ADDR, ACCESS> csid;
+   
+    /* Chip select default */
+   mmio_regs::sifive_spi0_0::csdef<BASE_ADDR, ACCESS> csdef;
+   
+    /* Chip select mode */
+   mmio_regs::sifive_spi0_0::csmode<BASE_ADDR, ACCESS> csmode;
+   
+    /* Delay control 0 */
+   mmio_regs::sifive_spi0_0::delay0<BASE_ADDR, ACCESS> delay0;
+   
+    /* Delay control 1 */
+   mmio_regs::sifive_spi0_0::delay1<BASE_ADDR, ACCESS> delay1;
+   
+    /* Frame format */
+   mmio_regs::sifive_spi0_0::fmt<BASE_ADDR, ACCESS> fmt;
+   
+    /* Transmit data */
+   mmio_regs::sifive_spi0_0::txdata<BASE_ADDR, ACCESS> txdata;
+   
+    /* Receive data */
+   mmio_regs::sifive_spi0_0::rxdata<BASE_ADDR, ACCESS> rxdata;
+   
+    /* Transmit watermark */
+   mmio_regs::sifive_spi0_0::txmark<BASE_ADDR, ACCESS> txmark;
+   
+    /* Receive watermark */
+   mmio_regs::sifive_spi0_0::rxmark<BASE_ADDR, ACCESS> rxmark;
+   
+    /* SPI flash interface control */
+   mmio_regs::sifive_spi0_0::fctrl<BASE_ADDR, ACCESS> fctrl;
+   
+    /* SPI flash instruction format */
+   mmio_regs::sifive_spi0_0::ffmt<BASE_ADDR, ACCESS> ffmt;
+   
+    /* SPI interrupt enable */
+   mmio_regs::sifive_spi0_0::ie<BASE_ADDR, ACCESS> ie;
+   
+    /* SPI interrupt pending */
+   mmio_regs::sifive_spi0_0::ip<BASE_ADDR, ACCESS> ip;
+   
+}; /* sifive_spi0_0_dev  */
+
+}
+
+#endif // SIFIVE_SPI0_0_MMIO_DEV_HPP
@@ -0,0 +1,346 @@
+/*
+   Register and field offset and size definitions for peripheral sifive_spi0_0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_SPI0_0_MMIO_PARAMS_HPP
+#define SIFIVE_SPI0_0_MMIO_PARAMS_HPP
+
+#include <cstdint>
+
+namespace mmio_param {
+    /* From sifive,spi0 peripheral generator */
+    namespace sifive_spi0_0 {
+       /* Serial clock divisor */
+       struct sckdiv_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x0;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 1;
+           /* Divisor, f_sck = f_in / (2*(div+1)) */
+           struct div_f {
+               using datatype = std::uint16_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 12;
+               static constexpr std::uint32_t bit_mask = 0xfff;
+           }; /* div_f */
+       }; /* sckdiv_r */
+       /* Serial clock mode */
+       struct sckmode_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x4;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 2;
+           /* Serial clock phase */
+           struct pha_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x1;
+           }; /* pha_f */
+           /* Serial clock polarity */
+           struct pol_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 1;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x2;
+           }; /* pol_f */
+       }; /* sckmode_r */
+       /* Chip select ID */
+       struct csid_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x10;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+       }; /* csid_r */
+       /* Chip select default */
+       struct csdef_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x14;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 0;
+       }; /* csdef_r */
+       /* Chip select mode */
+       struct csmode_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x18;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 1;
+           /* Chip select mode, 0 AUTO, 2 HOLD, 3 OFF */
+           struct mode_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 2;
+               static constexpr std::uint32_t bit_mask = 0x3;
+           }; /* mode_f */
+       }; /* csmode_r */
+       /* Delay control 0 */
+       struct delay0_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x28;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 2;
+           /* CS to SCK delay */
+           struct cssck_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 8;
+               static constexpr std::uint32_t bit_mask = 0xff;
+           }; /* cssck_f */
+           /* SCK to CS delay */
+           struct sckcs_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 16;
+               static constexpr unsigned int bit_width = 8;
+               static constexpr std::uint32_t bit_mask = 0xff0000;
+           }; /* sckcs_f */
+       }; /* delay0_r */
+       /* Delay control 1 */
+       struct delay1_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x2c;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 2;
+           /* Minimum CS inactive time */
+           struct intercs_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 8;
+               static constexpr std::uint32_t bit_mask = 0xff;
+           }; /* intercs_f */
+           /* Maximum interframe delay */
+           struct interxfr_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 16;
+               static constexpr unsigned int bit_width = 8;
+               static constexpr std::uint32_t bit_mask = 0xff0000;
+           }; /* interxfr_f */
+       }; /* delay1_r */
+       /* Frame format */
+       struct fmt_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x40;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 4;
+           /* SPI protocol, 0 single, 1 dual, 2 quad */
+           struct proto_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 2;
+               static constexpr std::uint32_t bit_mask = 0x3;
+           }; /* proto_f */
+           /* SPI endianness, 0 MSB first */
+           struct endian_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 2;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x4;
+           }; /* endian_f */
+           /* SPI I/O direction, 1 transmit only */
+           struct dir_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 3;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x8;
+           }; /* dir_f */
+           /* Number of bits per frame */
+           struct len_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 16;
+               static constexpr unsigned int bit_width = 4;
+               static constexpr std::uint32_t bit_mask = 0xf0000;
+           }; /* len_f */
+       }; /* fmt_r */
+       /* Transmit data */
+       struct txdata_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x48;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 2;
+           /* Transmit data */
+           struct data_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 8;
+               static constexpr std::uint32_t bit_mask = 0xff;
+           }; /* data_f */
+           /* FIFO full flag */
+           struct full_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 31;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x80000000;
+           }; /* full_f */
+       }; /* txdata_r */
+       /* Receive data */
+       struct rxdata_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x4c;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 2;
+           /* Received data */
+           struct data_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 8;
+               static constexpr std::uint32_t bit_mask = 0xff;
+           }; /* data_f */
+           /* FIFO empty flag */
+           struct empty_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 31;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x80000000;
+           }; /* empty_f */
+       }; /* rxdata_r */
+       /* Transmit watermark */
+       struct txmark_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x50;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 1;
+           /* Transmit watermark */
+           struct txmark_0_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 3;
+               static constexpr std::uint32_t bit_mask = 0x7;
+           }; /* txmark_0_f */
+       }; /* txmark_r */
+       /* Receive watermark */
+       struct rxmark_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x54;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 1;
+           /* Receive watermark */
+           struct rxmark_0_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 3;
+               static constexpr std::uint32_t bit_mask = 0x7;
+           }; /* rxmark_0_f */
+       }; /* rxmark_r */
+       /* SPI flash interface control */
+       struct fctrl_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x60;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 1;
+           /* SPI flash mode select, memory-mapped reads */
+           struct en_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x1;
+           }; /* en_f */
+       }; /* fctrl_r */
+       /* SPI flash instruction format */
+       struct ffmt_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x64;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 8;
+           /* Enable sending of command */
+           struct cmd_en_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x1;
+           }; /* cmd_en_f */
+           /* Number of address bytes */
+           struct addr_len_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 1;
+               static constexpr unsigned int bit_width = 3;
+               static constexpr std::uint32_t bit_mask = 0xe;
+           }; /* addr_len_f */
+           /* Number of dummy cycles */
+           struct pad_cnt_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 4;
+               static constexpr unsigned int bit_width = 4;
+               static constexpr std::uint32_t bit_mask = 0xf0;
+           }; /* pad_cnt_f */
+           /* Protocol for transmitting command */
+           struct cmd_proto_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 8;
+               static constexpr unsigned int bit_width = 2;
+               static constexpr std::uint32_t bit_mask = 0x300;
+           }; /* cmd_proto_f */
+           /* Protocol for transmitting address and padding */
+           struct addr_proto_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 10;
+               static constexpr unsigned int bit_width = 2;
+               static constexpr std::uint32_t bit_mask = 0xc00;
+           }; /* addr_proto_f */
+           /* Protocol for receiving data bytes */
+           struct data_proto_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 12;
+               static constexpr unsigned int bit_width = 2;
+               static constexpr std::uint32_t bit_mask = 0x3000;
+           }; /* data_proto_f */
+           /* Value of command byte */
+           struct cmd_code_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 16;
+               static constexpr unsigned int bit_width = 8;
+               static constexpr std::uint32_t bit_mask = 0xff0000;
+           }; /* cmd_code_f */
+           /* First 8 bits to transmit during dummy cycles */
+           struct pad_code_f {
+               using datatype = std::uint8_t;
+               static constexpr unsigned int bit_offset = 24;
+               static constexpr unsigned int bit_width = 8;
+               static constexpr std::uint32_t bit_mask = 0xff000000;
+           }; /* pad_code_f */
+       }; /* ffmt_r */
+       /* SPI interrupt enable */
+       struct ie_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x70;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 2;
+           /* Transmit watermark enable */
+           struct txwm_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x1;
+           }; /* txwm_f */
+           /* Receive watermark enable */
+           struct rxwm_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 1;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x2;
+           }; /* rxwm_f */
+       }; /* ie_r */
+       /* SPI interrupt pending */
+       struct ip_r {
+           using datatype = std::uint32_t;
+           static constexpr unsigned int offset = 0x74;
+           static constexpr unsigned int bit_width = 32;
+           static constexpr unsigned int field_count = 2;
+           /* Transmit watermark pending */
+           struct txwm_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 0;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x1;
+           }; /* txwm_f */
+           /* Receive watermark pending */
+           struct rxwm_f {
+               using datatype = bool;
+               static constexpr unsigned int bit_offset = 1;
+               static constexpr unsigned int bit_width = 1;
+               static constexpr std::uint32_t bit_mask = 0x2;
+           }; /* rxwm_f */
+       }; /* ip_r */
+    }
+}
+
+#endif // SIFIVE_SPI0_0_MMIO_PARAMS_HPP
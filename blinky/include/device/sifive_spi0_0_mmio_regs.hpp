@@ -0,0 +1,191 @@
+/*
+   Register class and field definition for peripheral sifive_spi0_0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_SPI0_0_MMIO_REGS_HPP
+#define SIFIVE_SPI0_0_MMIO_REGS_HPP
+
+#include <cstdint>
+#include "mmio_device.hpp"
+#include "sifive_spi0_0_mmio_param.hpp"
+
+namespace mmio_regs {
+    /* From sifive,spi0 peripheral generator */
+    namespace sifive_spi0_0 {
+        /* Serial clock divisor */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class sckdiv 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::sckdiv_r, ACCESS> {
+        public:
+            /* Divisor, f_sck = f_in / (2*(div+1)) */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::sckdiv_r, mmio_param::sifive_spi0_0::sckdiv_r::div_f, ACCESS> div;
+        }; /* sckdiv */
+        /* Serial clock mode */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class sckmode 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::sckmode_r, ACCESS> {
+        public:
+            /* Serial clock phase */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::sckmode_r, mmio_param::sifive_spi0_0::sckmode_r::pha_f, ACCESS> pha;
+            /* Serial clock polarity */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::sckmode_r, mmio_param::sifive_spi0_0::sckmode_r::pol_f, ACCESS> pol;
+        }; /* sckmode */
+        /* Chip select ID */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class csid 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::csid_r, ACCESS> {
+        }; /* csid */
+        /* Chip select default */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class csdef 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::csdef_r, ACCESS> {
+        }; /* csdef */
+        /* Chip select mode */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class csmode 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::csmode_r, ACCESS> {
+        public:
+            /* Chip select mode, 0 AUTO, 2 HOLD, 3 OFF */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::csmode_r, mmio_param::sifive_spi0_0::csmode_r::mode_f, ACCESS> mode;
+        }; /* csmode */
+        /* Delay control 0 */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class delay0 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::delay0_r, ACCESS> {
+        public:
+            /* CS to SCK delay */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::delay0_r, mmio_param::sifive_spi0_0::delay0_r::cssck_f, ACCESS> cssck;
+            /* SCK to CS delay */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::delay0_r, mmio_param::sifive_spi0_0::delay0_r::sckcs_f, ACCESS> sckcs;
+        }; /* delay0 */
+        /* Delay control 1 */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class delay1 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::delay1_r, ACCESS> {
+        public:
+            /* Minimum CS inactive time */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::delay1_r, mmio_param::sifive_spi0_0::delay1_r::intercs_f, ACCESS> intercs;
+            /* Maximum interframe delay */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::delay1_r, mmio_param::sifive_spi0_0::delay1_r::interxfr_f, ACCESS> interxfr;
+        }; /* delay1 */
+        /* Frame format */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class fmt 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::fmt_r, ACCESS> {
+        public:
+            /* SPI protocol, 0 single, 1 dual, 2 quad */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::fmt_r, mmio_param::sifive_spi0_0::fmt_r::proto_f, ACCESS> proto;
+            /* SPI endianness, 0 MSB first */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::fmt_r, mmio_param::sifive_spi0_0::fmt_r::endian_f, ACCESS> endian;
+            /* SPI I/O direction, 1 transmit only */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::fmt_r, mmio_param::sifive_spi0_0::fmt_r::dir_f, ACCESS> dir;
+            /* Number of bits per frame */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::fmt_r, mmio_param::sifive_spi0_0::fmt_r::len_f, ACCESS> len;
+        }; /* fmt */
+        /* Transmit data */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class txdata 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::txdata_r, ACCESS> {
+        public:
+            /* Transmit data */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::txdata_r, mmio_param::sifive_spi0_0::txdata_r::data_f, ACCESS> data;
+            /* FIFO full flag */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::txdata_r, mmio_param::sifive_spi0_0::txdata_r::full_f, ACCESS> full;
+        }; /* txdata */
+        /* Receive data */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class rxdata 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::rxdata_r, ACCESS> {
+        public:
+            /* Received data */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::rxdata_r, mmio_param::sifive_spi0_0::rxdata_r::data_f, ACCESS> data;
+            /* FIFO empty flag */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::rxdata_r, mmio_param::sifive_spi0_0::rxdata_r::empty_f, ACCESS> empty;
+        }; /* rxdata */
+        /* Transmit watermark */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class txmark 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::txmark_r, ACCESS> {
+        public:
+            /* Transmit watermark */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::txmark_r, mmio_param::sifive_spi0_0::txmark_r::txmark_0_f, ACCESS> txmark_0;
+        }; /* txmark */
+        /* Receive watermark */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class rxmark 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::rxmark_r, ACCESS> {
+        public:
+            /* Receive watermark */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::rxmark_r, mmio_param::sifive_spi0_0::rxmark_r::rxmark_0_f, ACCESS> rxmark_0;
+        }; /* rxmark */
+        /* SPI flash interface control */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class fctrl 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::fctrl_r, ACCESS> {
+        public:
+            /* SPI flash mode select, memory-mapped reads */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::fctrl_r, mmio_param::sifive_spi0_0::fctrl_r::en_f, ACCESS> en;
+        }; /* fctrl */
+        /* SPI flash instruction format */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class ffmt 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::ffmt_r, ACCESS> {
+        public:
+            /* Enable sending of command */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ffmt_r, mmio_param::sifive_spi0_0::ffmt_r::cmd_en_f, ACCESS> cmd_en;
+            /* Number of address bytes */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ffmt_r, mmio_param::sifive_spi0_0::ffmt_r::addr_len_f, ACCESS> addr_len;
+            /* Number of dummy cycles */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ffmt_r, mmio_param::sifive_spi0_0::ffmt_r::pad_cnt_f, ACCESS> pad_cnt;
+            /* Protocol for transmitting command */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ffmt_r, mmio_param::sifive_spi0_0::ffmt_r::cmd_proto_f, ACCESS> cmd_proto;
+            /* Protocol for transmitting address and padding */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ffmt_r, mmio_param::sifive_spi0_0::ffmt_r::addr_proto_f, ACCESS> addr_proto;
+            /* Protocol for receiving data bytes */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ffmt_r, mmio_param::sifive_spi0_0::ffmt_r::data_proto_f, ACCESS> data_proto;
+            /* Value of command byte */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ffmt_r, mmio_param::sifive_spi0_0::ffmt_r::cmd_code_f, ACCESS> cmd_code;
+            /* First 8 bits to transmit during dummy cycles */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ffmt_r, mmio_param::sifive_spi0_0::ffmt_r::pad_code_f, ACCESS> pad_code;
+        }; /* ffmt */
+        /* SPI interrupt enable */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class ie 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::ie_r, ACCESS> {
+        public:
+            /* Transmit watermark enable */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ie_r, mmio_param::sifive_spi0_0::ie_r::txwm_f, ACCESS> txwm;
+            /* Receive watermark enable */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ie_r, mmio_param::sifive_spi0_0::ie_r::rxwm_f, ACCESS> rxwm;
+        }; /* ie */
+        /* SPI interrupt pending */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class ip 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_spi0_0::ip_r, ACCESS> {
+        public:
+            /* Transmit watermark pending */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ip_r, mmio_param::sifive_spi0_0::ip_r::txwm_f, ACCESS> txwm;
+            /* Receive watermark pending */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_spi0_0::ip_r, mmio_param::sifive_spi0_0::ip_r::rxwm_f, ACCESS> rxwm;
+        }; /* ip */
+    } /* sifive_spi0_0 */
+} /* mmio_regs */
+
+#endif // SIFIVE_SPI0_0_MMIO_REGS_HPP
@@ -0,0 +1,96 @@
+/*
+   Register class and field definition for peripheral sifive_uart0_0.
+   SPDX-License-Identifier: Unlicense
+*/
+
+#ifndef SIFIVE_UART0_0_MMIO_REGS_HPP
+#define SIFIVE_UART0_0_MMIO_REGS_HPP
+
+#include <cstdint>
+#include "mmio_device.hpp"
+#include "sifive_uart0_0_mmio_param.hpp"
+
+namespace mmio_regs {
+    /* From sifive,uart0,control peripheral generator */
+    namespace sifive_uart0_0 {
+        /* Transmit data register */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class txdata 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_uart0_0::txdata_r, ACCESS> {
+        public:
+            /* Transmit data */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::txdata_r, mmio_param::sifive_uart0_0::txdata_r::data_f, ACCESS> data;
+            /* Transmit FIFO full */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::txdata_r, mmio_param::sifive_uart0_0::txdata_r::full_f, ACCESS> full;
+        }; /* txdata */
+        /* Receive data register */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class rxdata 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_uart0_0::rxdata_r, ACCESS> {
+        public:
+            /* Received data */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::rxdata_r, mmio_param::sifive_uart0_0::rxdata_r::data_f, ACCESS> data;
+            /* Receive FIFO empty */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::rxdata_r, mmio_param::sifive_uart0_0::rxdata_r::empty_f, ACCESS> empty;
+        }; /* rxdata */
+        /* Transmit control register */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class txctrl 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_uart0_0::txctrl_r, ACCESS> {
+        public:
+            /* Transmit enable */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::txctrl_r, mmio_param::sifive_uart0_0::txctrl_r::txen_f, ACCESS> txen;
+            /* Number of stop bits */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::txctrl_r, mmio_param::sifive_uart0_0::txctrl_r::nstop_f, ACCESS> nstop;
+            /* Transmit watermark level */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::txctrl_r, mmio_param::sifive_uart0_0::txctrl_r::txcnt_f, ACCESS> txcnt;
+        }; /* txctrl */
+        /* Receive control register */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class rxctrl 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_uart0_0::rxctrl_r, ACCESS> {
+        public:
+            /* Receive enable */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::rxctrl_r, mmio_param::sifive_uart0_0::rxctrl_r::rxen_f, ACCESS> rxen;
+            /* Receive watermark level */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::rxctrl_r, mmio_param::sifive_uart0_0::rxctrl_r::rxcnt_f, ACCESS> rxcnt;
+        }; /* rxctrl */
+        /* UART interrupt enable */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class ie 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_uart0_0::ie_r, ACCESS> {
+        public:
+            /* Transmit watermark interrupt enable */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::ie_r, mmio_param::sifive_uart0_0::ie_r::txwm_f, ACCESS> txwm;
+            /* Receive watermark interrupt enable */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::ie_r, mmio_param::sifive_uart0_0::ie_r::rxwm_f, ACCESS> rxwm;
+        }; /* ie */
+        /* UART interrupt pending */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class ip 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_uart0_0::ip_r, ACCESS> {
+        public:
+            /* Transmit watermark interrupt pending */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::ip_r, mmio_param::sifive_uart0_0::ip_r::txwm_f, ACCESS> txwm;
+            /* Receive watermark interrupt pending */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::ip_r, mmio_param::sifive_uart0_0::ip_r::rxwm_f, ACCESS> rxwm;
+        }; /* ip */
+        /* Baud rate divisor */
+        template<const std::uintptr_t BASE_ADDR,
+                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class div 
+            : public mmio_device::reg<BASE_ADDR, 
+                                mmio_param::sifive_uart0_0::div_r, ACCESS> {
+        public:
+            /* Baud rate divisor */
+            mmio_device::reg_field<BASE_ADDR, mmio_param::sifive_uart0_0::div_r, mmio_param::sifive_uart0_0::div_r::div_0_f, ACCESS> div_0;
+        }; /* div */
+    } /* sifive_uart0_0 */
+} /* mmio_regs */
+
+#endif // SIFIVE_UART0_0_MMIO_REGS_HPP
@@ -0,0 +1,150 @@
+/*
+   Typed GPIO pins for the sifive_gpio0_0 device.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Pin masks are computed at compile time, and each set/clear/toggle is a single
+   bus access:
+
+   - Shadowed output_val (mmio_device::shadow_access) : A single store, the
+     read-modify-write is done on the RAM copy.
+   - Direct output_val                                 : A single AMO instruction
+     (amoor/amoand/amoxor), or a critical section without the A extension.
+
+   e.g.
+       driver::sifive_gpio0_0_dev<SIFIVE_GPIO0_0, mmio_device::shadow_access> gpio_dev;
+       driver::pin_group<decltype(gpio_dev), LED_RED, LED_GREEN, LED_BLUE> leds(gpio_dev);
+       leds.output();
+       leds.toggle();
+
+*/
+
+#ifndef GPIO_HPP
+#define GPIO_HPP
+
+#include <cstdint>
+
+// Compile time bit masks
+#include "util.hpp"
+
+namespace driver {
+
+    /** A group of GPIO pins of one device, accessed together.
+        @tparam DEV  GPIO device type, e.g. sifive_gpio0_0_dev<BASE_ADDR, ...>
+        @tparam PINS Pin numbers.
+        @note With a shadowed output_val, modifications are not atomic. Pins modified by both
+              interrupt handlers and the main loop should use a direct output_val.
+     */
+    template<class DEV, unsigned int... PINS> class pin_group {
+    public:
+        static_assert(sizeof...(PINS) > 0, "A pin group needs at least one pin");
+        static_assert(((PINS < 32) && ...), "The GPIO device has 32 pins");
+
+        /** Mask of all pins in the group */
+        static constexpr std::uint32_t MASK = (util::bitmask(PINS) | ...);
+
+        explicit pin_group(DEV &dev)
+            : _dev(dev) {}
+
+        /** Drive the pins high */
+        void set(void) {
+            if constexpr (output_val_t::access_t::shadowed) {
+                _dev.output_val |= MASK;
+            } else {
+                _dev.output_val.set(MASK);
+            }
+        }
+        /** Drive the pins low */
+        void clear(void) {
+            if constexpr (output_val_t::access_t::shadowed) {
+                _dev.output_val &= ~MASK;
+            } else {
+                _dev.output_val.clr(MASK);
+            }
+        }
+        /** Invert the pins */
+        void toggle(void) {
+            if constexpr (output_val_t::access_t::shadowed) {
+                _dev.output_val ^= MASK;
+            } else {
+                _dev.output_val.toggle(MASK);
+            }
+        }
+        /** Drive the pins to the bits of value at the pin positions.
+            A single store with a shadowed output_val, otherwise a read-modify-write.
+         */
+        void write(std::uint32_t value) {
+            using access_t = typename output_val_t::access_t;
+            access_t::write((access_t::read_for_modify() & ~MASK) | (value & MASK));
+        }
+        /** Read the pin inputs, masked at the pin positions */
+        std::uint32_t read(void) {
+            return _dev.input_val.read() & MASK;
+        }
+
+        /** Configure the pins as outputs.
+            The configuration is read from the registers, not the shadow copies,
+            so other pins keep the configuration set by other code, e.g. a boot loader.
+         */
+        void output(void) {
+            configure(_dev.iof_en, MASK, 0);
+            configure(_dev.output_en, 0, MASK);
+        }
+        /** Configure the pins as inputs */
+        void input(void) {
+            configure(_dev.output_en, MASK, 0);
+            configure(_dev.iof_en, MASK, 0);
+            configure(_dev.input_en, 0, MASK);
+        }
+        /** Connect the pins to a hardware I/O function, e.g. the UART (IOF0) or PWM (IOF1)
+            @tparam FUNCTION I/O function 0 or 1.
+         */
+        template<unsigned int FUNCTION> void iof(void) {
+            static_assert(FUNCTION < 2, "The GPIO device has two I/O functions");
+            if constexpr (FUNCTION == 0) {
+                configure(_dev.iof_sel, MASK, 0);
+            } else {
+                configure(_dev.iof_sel, 0, MASK);
+            }
+            configure(_dev.iof_en, 0, MASK);
+        }
+
+    protected:
+        using output_val_t = decltype(DEV::output_val);
+        DEV &_dev;
+
+    private:
+        /** Read-modify-write of a configuration register from the bus value.
+            The write also updates the RAM copy of a shadowed register.
+         */
+        template<class REG> static void configure(REG &reg, std::uint32_t clear_mask, std::uint32_t set_mask) {
+            reg.write((reg.read() & ~clear_mask) | set_mask);
+        }
+    };
+
+    /** A single GPIO pin.
+        @tparam DEV GPIO device type, e.g. sifive_gpio0_0_dev<BASE_ADDR, ...>
+        @tparam PIN Pin number.
+     */
+    template<class DEV, unsigned int PIN> class pin : public pin_group<DEV, PIN> {
+    public:
+        explicit pin(DEV &dev)
+            : pin_group<DEV, PIN>(dev) {}
+
+        /** Drive the pin to a level */
+        void write(bool value) {
+            if (value) {
+                this->set();
+            } else {
+                this->clear();
+            }
+        }
+        /** Read the pin input level */
+        bool read(void) {
+            return pin_group<DEV, PIN>::read() != 0;
+        }
+    };
+}
+
+#endif // #ifndef GPIO_HPP
@@ -0,0 +1,166 @@
+/*
+   GPIO edge interrupts for the sifive_gpio0_0 device.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Each GPIO pin has its own PLIC source. A function object is bound to the
+   rising and/or falling edge of a pin, the PLIC dispatches the pin source to
+   this driver, which clears the pending edges and calls the edge handlers.
+
+   The edge is latched by the GPIO device, so short pulses are not missed
+   and no CPU time is spent polling input_val.
+
+   e.g.
+       driver::gpio_irq<decltype(gpio_dev), decltype(plic)> gpio_irq(gpio_dev, plic);
+       static const auto button_pressed = [&] (void) { ... };
+       gpio_irq.attach<BUTTON, driver::edge::fall>(button_pressed);
+
+*/
+
+#ifndef GPIO_IRQ_HPP
+#define GPIO_IRQ_HPP
+
+#include <cstdint>
+
+// Critical sections
+#include "critical_section.hpp"
+
+// Compile time bit masks
+#include "util.hpp"
+
+namespace driver {
+
+    /** Pin edges that generate an interrupt */
+    enum class edge {
+        rise,
+        fall,
+        both
+    };
+
+    /** SiFive-hifive1-revb GPIO interrupt parameters
+     */
+    struct default_gpio_irq_config {
+        // See
+        // freedom-e-sdk/bsp/sifive-hifive1-revb/core.dts
+        // gpio@10012000: interrupts = <8 9 10 ... 39>
+        // PLIC source ID of pin 0, pin N is FIRST_SOURCE + N.
+        static constexpr unsigned int FIRST_SOURCE=8;
+        static constexpr unsigned int PIN_COUNT=32;
+        // PLIC priority of the GPIO sources.
+        static constexpr unsigned int PRIORITY=1;
+    };
+
+    /** GPIO edge interrupt driver.
+        @tparam DEV    GPIO device type, e.g. sifive_gpio0_0_dev<BASE_ADDR, ...>
+        @tparam PLIC   PLIC driver type, e.g. plic<riscv_plic0_dev<BASE_ADDR>>
+        @tparam CONFIG PLIC source IDs of the pins.
+     */
+    template<class DEV, class PLIC, class CONFIG=default_gpio_irq_config> class gpio_irq {
+    public:
+        gpio_irq(DEV &dev, PLIC &plic)
+            : _plic(plic) {
+            _dev = &dev;
+        }
+        // Boilerplate delete defaults - non copyable class
+        gpio_irq(const gpio_irq&) = delete;
+        gpio_irq &operator=(const gpio_irq&) = delete;
+        gpio_irq(gpio_irq&&) = delete;
+        gpio_irq &operator=(gpio_irq&&) = delete;
+
+        /** Call a function object on an edge of a pin, from the machine external interrupt.
+            The pin is configured as an input and its PLIC source is enabled.
+            This is defined as a template to prevent dynamic memory allocation.
+         */
+        template<unsigned int PIN, edge EDGE, class T> void attach(T const &isr_handler) {
+            static_assert(PIN < CONFIG::PIN_COUNT, "Invalid GPIO pin");
+            constexpr std::uint32_t mask = util::bitmask(PIN);
+            {
+                // The function and context must be updated together with respect to the ISR.
+                irq::critical_section lock;
+                const binding this_binding = {
+                    [](const void *context)
+                    {
+                        // Call into the function object.
+                        static_cast<T const *>(context)->operator()();
+                    },
+                    &isr_handler
+                };
+                if constexpr (EDGE != edge::fall) {
+                    _rise[PIN] = this_binding;
+                }
+                if constexpr (EDGE != edge::rise) {
+                    _fall[PIN] = this_binding;
+                }
+            }
+            _dev->output_en &= ~mask;
+            _dev->iof_en &= ~mask;
+            _dev->input_en |= mask;
+            // Discard edges latched before the handler was attached.
+            _dev->rise_ip.write(mask);
+            _dev->fall_ip.write(mask);
+            if constexpr (EDGE != edge::fall) {
+                _dev->rise_ie.set(mask);
+            }
+            if constexpr (EDGE != edge::rise) {
+                _dev->fall_ie.set(mask);
+            }
+            _plic.template bind<CONFIG::FIRST_SOURCE + PIN>(_pin_handler<PIN>);
+            _plic.template enable<CONFIG::FIRST_SOURCE + PIN>(CONFIG::PRIORITY);
+        }
+
+        /** Stop the interrupts of a pin. */
+        template<unsigned int PIN> void detach(void) {
+            static_assert(PIN < CONFIG::PIN_COUNT, "Invalid GPIO pin");
+            constexpr std::uint32_t mask = util::bitmask(PIN);
+            _plic.template disable<CONFIG::FIRST_SOURCE + PIN>();
+            _dev->rise_ie.clr(mask);
+            _dev->fall_ie.clr(mask);
+            _plic.template unbind<CONFIG::FIRST_SOURCE + PIN>();
+            irq::critical_section lock;
+            _rise[PIN] = {};
+            _fall[PIN] = {};
+        }
+
+    private:
+        PLIC &_plic;
+
+        /** Type erased function object call */
+        struct binding {
+            void (*execute)(const void *context);
+            const void *context;
+        };
+
+        /** PLIC source handler of a pin. */
+        template<unsigned int PIN> struct pin_handler {
+            void operator()(void) const {
+                constexpr std::uint32_t mask = util::bitmask(PIN);
+                // The pending bits are write 1 to clear. Clear before calling the handlers
+                // so an edge during the handler is latched again.
+                const bool rise = (_dev->rise_ip.read() & mask) != 0;
+                const bool fall = (_dev->fall_ip.read() & mask) != 0;
+                if (rise) {
+                    _dev->rise_ip.write(mask);
+                }
+                if (fall) {
+                    _dev->fall_ip.write(mask);
+                }
+                if (rise && _rise[PIN].execute) {
+                    _rise[PIN].execute(_rise[PIN].context);
+                }
+                if (fall && _fall[PIN].execute) {
+                    _fall[PIN].execute(_fall[PIN].context);
+                }
+            }
+        };
+        template<unsigned int PIN> static inline const pin_handler<PIN> _pin_handler = {};
+
+        // One GPIO device per PLIC source range, the handlers are shared by all instances.
+        static inline DEV *_dev;
+        // Zero initialized, edges with no bound function object have a null execute pointer.
+        static inline binding _rise[CONFIG::PIN_COUNT] = {};
+        static inline binding _fall[CONFIG::PIN_COUNT] = {};
+    };
+}
+
+#endif // #ifndef GPIO_IRQ_HPP
@@ -0,0 +1,457 @@
+/*
+   Machine mode interrupt handler installation for RISC-V.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Two ways to install C++ function objects as interrupt handlers:
+
+   - irq::handler          : Direct mode. A single entry point for all interrupts.
+   - irq::vectored_handler : Vectored mode. A jump table built at compile time
+                             with one entry per interrupt cause.
+   - irq::registry         : Direct mode. Independent function objects bound at run
+                             time to each interrupt source, dispatched by cause index.
+
+*/
+
+#ifndef IRQ_HPP
+#define IRQ_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+// RISC-V CSR definitions and access classes
+#include "riscv-csr.hpp"
+
+// RISC-V interrupt definitions
+#include "riscv-interrupts.hpp"
+
+// Exception dispatch, installed at vector table entry 0
+#include "trap.hpp"
+
+// Critical sections
+#include "critical_section.hpp"
+
+namespace irq {
+
+    // ------------------------------------------------------------------------
+    // Direct mode
+
+    // Machine mode interrupt service routine
+    // Defined as an interrupt function to ensure correct 'mret' exit is generated.
+    inline void entry(void) __attribute__ ((interrupt ("machine")));
+
+    /** IRQ Handler class. Allows a lambda function (or other function
+     * object) to be registered as the machine mode IRQ hander.
+     */
+    class handler {
+    public:
+        /** Create an IRQ handler class to install a
+            function as the machine mode irq handler */
+        template<class T> handler(T const &isr_handler);
+        // Boilerplate delete defaults - non copyable class
+        handler(const handler&) = delete;
+        handler &operator=(const handler&) = delete;
+        handler(handler&&) = delete;
+        handler &operator=(handler&&) = delete;
+    private :
+        static inline  void (*_execute_handler)(void);
+        // Trampoline function is required to bridge from the entry point
+        // function declared with specific attributes and alignments to this class member.
+        friend void entry(void);
+        static inline void handler_entry(void) {
+            _execute_handler();
+        }
+    };
+
+    // ------------------------------------------------------------------------
+    // Vectored mode
+
+    /** Number of entries in the vector table.
+        One entry for each of the standard interrupt causes, up to the machine external interrupt.
+     */
+    static constexpr std::uint32_t VECTOR_TABLE_SIZE = riscv::interrupts::mei + 1;
+
+    /** Alignment of the vector table.
+        The ISA only requires mtvec.BASE to be 4 byte aligned, but some implementations
+        (e.g. the SiFive CLINT) require 64 byte alignment in vectored mode.
+     */
+    static constexpr std::uintptr_t VECTOR_TABLE_ALIGN = 64;
+
+    /** mtvec.MODE value for vectored interrupts. */
+    static constexpr riscv::csr::uint_xlen_t MTVEC_MODE_VECTORED = 1;
+
+    /** Vector entry policy: The entry point calls the function object.
+        The compiler must save all caller saved registers if the function object makes any calls.
+     */
+    struct standard_entry {};
+    /** Vector entry policy: The function object, and all functions it calls, are inlined
+        into the entry point, so the interrupt prologue only needs to save the registers
+        that are clobbered by the handler. Intended for leaf handlers: a call that can not
+        be inlined, e.g. through a function pointer, makes the prologue save all caller
+        saved registers, the same as standard_entry. Compare the entry point prologues in
+        the disassembly (modern_cxx_blinky.disasm) before choosing this policy.
+     */
+    struct inline_entry {};
+
+    /** Mask of mie/mip bits for a set of interrupt causes.
+        e.g. `irq::mask_of<riscv::interrupts::mti, riscv::interrupts::msi>`
+     */
+    template<std::uint32_t ... CAUSES> static constexpr riscv::csr::uint_xlen_t mask_of =
+        ((static_cast<riscv::csr::uint_xlen_t>(1) << CAUSES) | ... | 0);
+
+    /** Vector entry policy: Nested interrupts.
+        The entry point saves mepc and mstatus, then re-enables mstatus.MIE while the
+        function object executes. Only the causes in PREEMPT_MASK are left enabled in mie,
+        this acts as a software priority threshold: the PREEMPT_MASK causes are the
+        higher priority interrupts that may preempt this handler.
+        All other causes are disabled until the handler returns.
+        @note Each nesting level requires additional stack for the saved registers.
+        @note The handler should not modify the mie bits outside of PREEMPT_MASK,
+              they are re-enabled on exit.
+     */
+    template<riscv::csr::uint_xlen_t PREEMPT_MASK> struct nested_entry {
+        static constexpr riscv::csr::uint_xlen_t preempt_mask = PREEMPT_MASK;
+    };
+    template<class P> struct is_nested_entry : std::false_type {};
+    template<riscv::csr::uint_xlen_t PREEMPT_MASK> struct is_nested_entry<nested_entry<PREEMPT_MASK>> : std::true_type {};
+
+    /** Bind a function object to an interrupt cause in the vector table.
+        The function object is called directly from the vector entry, no mcause
+        decode or trampoline function is required.
+     */
+    template<std::uint32_t CAUSE, class T, class ENTRY=standard_entry> class vector {
+    public:
+        static_assert(CAUSE < VECTOR_TABLE_SIZE, "Interrupt cause is outside of the vector table");
+
+        /** The interrupt cause (mcause exception code) handled by this vector */
+        static constexpr std::uint32_t cause = CAUSE;
+        /** The entry point policy for this vector */
+        using entry_policy = ENTRY;
+
+        constexpr explicit vector(T const &isr_handler)
+            : _isr_handler(isr_handler) {}
+
+        /** Save the context for the call from the vector entry point. */
+        void install(void) const {
+            _context = &_isr_handler;
+        }
+        /** Call into the function object. Called from the vector entry point. */
+        static inline void execute(void) {
+            _context->operator()();
+        }
+    private:
+        T const &_isr_handler;
+        // One context pointer per cause and function object type.
+        // Replaces the single mscratch context used in direct mode.
+        static inline T const *_context;
+    };
+
+    /** Create an irq::vector from a function object.
+        Allows the function object type to be deduced, e.g.
+        `irq::make_vector<riscv::interrupts::mti>(timer_handler)` or
+        `irq::make_vector<riscv::interrupts::mti, irq::inline_entry>(timer_handler)`
+     */
+    template<std::uint32_t CAUSE, class ENTRY=standard_entry, class T> constexpr vector<CAUSE, T, ENTRY> make_vector(T const &isr_handler) {
+        return vector<CAUSE, T, ENTRY>(isr_handler);
+    }
+
+    // Vector table entry point for a given irq::vector.
+    // Defined as an interrupt function to ensure correct 'mret' exit is generated.
+    template<class V> void vector_entry(void) __attribute__ ((interrupt ("machine")));
+
+    // Vector table entry point for a given irq::vector using irq::inline_entry.
+    // 'flatten' inlines every call made by the function object, so the register
+    // save/restore generated for the interrupt function is limited to the registers used.
+    template<class V> void inline_vector_entry(void) __attribute__ ((interrupt ("machine"), flatten));
+
+    // Vector table entry point for a given irq::vector using irq::nested_entry.
+    template<class V> void nested_vector_entry(void) __attribute__ ((interrupt ("machine")));
+
+    /** Select the entry point for an irq::vector according to its entry policy. */
+    template<class V> constexpr auto entry_of(void) -> void (*)(void) {
+        if constexpr (std::is_same_v<typename V::entry_policy, inline_entry>) {
+            return inline_vector_entry<V>;
+        } else if constexpr (is_nested_entry<typename V::entry_policy>::value) {
+            return nested_vector_entry<V>;
+        } else {
+            return vector_entry<V>;
+        }
+    }
+
+    // Vector table entry point for causes with no irq::vector.
+    // An enabled cause with no vector is fatal, returning would take the interrupt again.
+    // In vectored mode exceptions are also taken at entry 0, that entry defaults to irq::trap_entry.
+    inline void unhandled_entry(void) __attribute__ ((interrupt ("machine")));
+
+    /** Number of irq::vector types registered for the given cause. */
+    template<class ... VECTORS> constexpr unsigned int cause_count(std::uint32_t cause) {
+        return ((VECTORS::cause == cause ? 1U : 0U) + ... + 0U);
+    }
+
+    /** Select the entry point for a vector table entry at compile time. */
+    template<class ... VECTORS> constexpr auto select_entry(std::uint32_t cause) -> void (*)(void) {
+        void (*selected)(void) = (cause == 0) ? trap_entry : unhandled_entry;
+        ((selected = (VECTORS::cause == cause) ? entry_of<VECTORS>() : selected), ...);
+        return selected;
+    }
+
+    /** Vectored IRQ Handler class. Allows a set of lambda functions (or other function
+     * objects) to be registered as the machine mode IRQ handler for individual causes.
+     *
+     * The vector table is generated at compile time from the irq::vector types.
+     * Each table entry is a jump to an entry point that calls the function object directly.
+     */
+    template<class ... VECTORS> class vectored_handler {
+    public:
+        /** Create an IRQ handler class to install the vector table
+            as the machine mode irq handler */
+        vectored_handler(VECTORS const & ... vectors);
+        // Boilerplate delete defaults - non copyable class
+        vectored_handler(const vectored_handler&) = delete;
+        vectored_handler &operator=(const vectored_handler&) = delete;
+        vectored_handler(vectored_handler&&) = delete;
+        vectored_handler &operator=(vectored_handler&&) = delete;
+    private:
+        static_assert(((VECTORS::cause < VECTOR_TABLE_SIZE) && ...), "Interrupt cause is outside of the vector table");
+
+        static_assert(((cause_count<VECTORS...>(VECTORS::cause) == 1) && ...), "Only one vector can be registered per interrupt cause");
+
+        using entry_t = void (*)(void);
+
+        // The entries are evaluated as constants so they can be used as immediate asm operands.
+        static constexpr entry_t _entry_0 = select_entry<VECTORS...>(0);
+        static constexpr entry_t _entry_1 = select_entry<VECTORS...>(1);
+        static constexpr entry_t _entry_2 = select_entry<VECTORS...>(2);
+        static constexpr entry_t _entry_3 = select_entry<VECTORS...>(3);
+        static constexpr entry_t _entry_4 = select_entry<VECTORS...>(4);
+        static constexpr entry_t _entry_5 = select_entry<VECTORS...>(5);
+        static constexpr entry_t _entry_6 = select_entry<VECTORS...>(6);
+        static constexpr entry_t _entry_7 = select_entry<VECTORS...>(7);
+        static constexpr entry_t _entry_8 = select_entry<VECTORS...>(8);
+        static constexpr entry_t _entry_9 = select_entry<VECTORS...>(9);
+        static constexpr entry_t _entry_10 = select_entry<VECTORS...>(10);
+        static constexpr entry_t _entry_11 = select_entry<VECTORS...>(11);
+
+        // The vector table. A naked function of jump instructions, one per cause.
+        static void vector_table(void) __attribute__ ((naked, aligned(VECTOR_TABLE_ALIGN)));
+    };
+
+    // ------------------------------------------------------------------------
+    // Interrupt source registry
+
+    // Machine mode interrupt service routine for the registry.
+    // Defined as an interrupt function to ensure correct 'mret' exit is generated.
+    inline void registry_entry(void) __attribute__ ((interrupt ("machine")));
+
+    /** Interrupt source registry.
+     *  Holds one function object binding per interrupt cause, so independent drivers
+     *  can each install their own handler. The entry point uses the cause as an index
+     *  into the binding table.
+     *  The registry entry does not save a trap frame, so exceptions and enabled causes with
+     *  no binding are fatal (irq::fatal_trap). Use irq::vectored_handler for the exception registry.
+     */
+    class registry {
+    public:
+        /** Write the registry entry point to the mtvec register. */
+        static void install(void);
+        /** Bind a function object to an interrupt cause.
+            This is defined as a template to prevent dynamic memory allocation. */
+        template<std::uint32_t CAUSE, class T> static void bind(T const &isr_handler);
+        /** Remove the binding for an interrupt cause. */
+        template<std::uint32_t CAUSE> static void unbind(void);
+    private:
+        /** Type erased function object call */
+        struct binding {
+            void (*execute)(const void *context);
+            const void *context;
+        };
+        // Default for causes with no bound function object
+        static void unbound(const void *) {
+            fatal_trap();
+        }
+
+        static inline binding _bindings[VECTOR_TABLE_SIZE] = {
+            {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr},
+            {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr},
+            {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr},
+        };
+
+        friend void registry_entry(void);
+        static inline void dispatch(void) {
+            // In RISC-V the mcause register stores the cause of any interrupt or exception.
+            auto this_cause = riscv::csrs.mcause.read();
+            // The top bit of the mcause register indicates if this is an interrupt or exception.
+            if (this_cause & riscv::csr::mcause_data::interrupt::BIT_MASK) {
+                this_cause &= riscv::csr::mcause_data::exception_code::BIT_MASK;
+                if (this_cause < VECTOR_TABLE_SIZE) {
+                    binding const &this_binding = _bindings[this_cause];
+                    this_binding.execute(this_binding.context);
+                    return;
+                }
+            } else if (this_cause == riscv::exceptions::breakpoint) {
+                // Raised by fatal_trap() with no debugger attached.
+                halt();
+            }
+            // Exceptions, and causes outside the table.
+            fatal_trap();
+        }
+    };
+
+    /** Bind a function object to an interrupt source for the lifetime of this object.
+        e.g. `irq::source<riscv::interrupts::mti> timer_irq(timer_handler);`
+     */
+    template<std::uint32_t CAUSE> class source {
+    public:
+        static_assert(CAUSE < VECTOR_TABLE_SIZE, "Interrupt cause is outside of the registry");
+
+        template<class T> source(T const &isr_handler) {
+            registry::bind<CAUSE>(isr_handler);
+        }
+        ~source() {
+            registry::unbind<CAUSE>();
+        }
+        // Boilerplate delete defaults - non copyable class
+        source(const source&) = delete;
+        source &operator=(const source&) = delete;
+        source(source&&) = delete;
+        source &operator=(source&&) = delete;
+    };
+
+    // Implement the IRQ handler
+
+    // IRQ handler constructor
+    // This is defined as a template to prevent dynamic memory allocation
+    // by ensuring code can be generated according to the lambda function type defined in main.
+    // That ensures a std::function() does not need to be used as a generic function call interface.
+    template<class T> handler::handler(T const &isr_handler) {
+        // This will call the C++ function object method that represents the lamda function above.
+        // This is required to provide the context of the function call that is captured by the lambda.
+        // A RISC-V optimization uses the MSCRATCH register to hold the function object context pointer.
+        _execute_handler = [](void)
+            {
+                // Read the context from the interrupt scratch register.
+                uintptr_t isr_context = riscv::csrs.mscratch.read();
+                // Call into the lambda function.
+                return ((T *)isr_context)->operator()();
+            };
+        // Get a pointer to the IRQ context and save in the interrupt scratch register.
+        uintptr_t isr_context = (uintptr_t)&isr_handler;
+        riscv::csrs.mscratch.write( reinterpret_cast<std::uintptr_t>(isr_context) );
+        // Write the entry() function to the mtvec register to install our IRQ handler.
+        riscv::csrs.mtvec.write( reinterpret_cast<std::uintptr_t>(entry) );
+    }
+
+#pragma GCC push_options
+// Force the alignment for mtvec.BASE.
+// A 'xC' extension program could be aligned to to bytes.
+#pragma GCC optimize ("align-functions=4")
+    void entry(void)  {
+        // Jump into the function defined within the irq::handler class.
+        handler::handler_entry();
+    }
+#pragma GCC pop_options
+
+    // Vectored IRQ handler constructor
+    template<class ... VECTORS> vectored_handler<VECTORS...>::vectored_handler(VECTORS const & ... vectors) {
+        // Save the context of each function object for its vector entry point.
+        (vectors.install(), ...);
+        // Write the vector table address and the vectored mode to the mtvec register.
+        riscv::csrs.mtvec.write( (reinterpret_cast<std::uintptr_t>(vector_table) & ~riscv::csr::mtvec_data::mode::BIT_MASK)
+                                 | (MTVEC_MODE_VECTORED << riscv::csr::mtvec_data::mode::BIT_OFFSET) );
+    }
+
+    template<class V> void vector_entry(void) {
+        // Direct call, the cause is implied by the vector table entry.
+        V::execute();
+    }
+
+    template<class V> void inline_vector_entry(void) {
+        // Same as vector_entry(), the difference is in the attributes.
+        V::execute();
+    }
+
+    template<class V> void nested_vector_entry(void) {
+        constexpr riscv::csr::uint_xlen_t preempt_mask = V::entry_policy::preempt_mask;
+        static_assert((preempt_mask & mask_of<V::cause>) == 0, "A nested handler can not be preempted by its own cause");
+        // Save the trap state, a nested interrupt will overwrite these registers.
+        auto mepc_value = riscv::csrs.mepc.read();
+        auto mstatus_value = riscv::csrs.mstatus.read();
+        // Priority threshold, disable all causes that may not preempt this handler.
+        auto masked = riscv::csrs.mie.read_clr_bits(~preempt_mask) & ~preempt_mask;
+        // Global interrupt enable, allow higher priority interrupts.
+        riscv::csrs.mstatus.mie.set();
+        V::execute();
+        // Global interrupt disable before restoring the trap state.
+        riscv::csrs.mstatus.mie.clr();
+        riscv::csrs.mie.set(masked);
+        riscv::csrs.mepc.write(mepc_value);
+        riscv::csrs.mstatus.write(mstatus_value);
+    }
+
+    void unhandled_entry(void) {
+        fatal_trap();
+    }
+
+    template<class ... VECTORS> void vectored_handler<VECTORS...>::vector_table(void) {
+        // In vectored mode the hart jumps to mtvec.BASE + 4*cause.
+        // Compressed instructions are disabled so that each jump occupies exactly 4 bytes.
+        __asm__ volatile (
+            ".option push;"
+            ".option norvc;"
+            "j %0;"     /* 0  - usi, and all exceptions */
+            "j %1;"     /* 1  - ssi */
+            "j %2;"     /* 2  - reserved */
+            "j %3;"     /* 3  - msi */
+            "j %4;"     /* 4  - uti */
+            "j %5;"     /* 5  - sti */
+            "j %6;"     /* 6  - reserved */
+            "j %7;"     /* 7  - mti */
+            "j %8;"     /* 8  - uei */
+            "j %9;"     /* 9  - sei */
+            "j %10;"    /* 10 - reserved */
+            "j %11;"    /* 11 - mei */
+            ".option pop;"
+            : /* output: none */
+            : "i" (_entry_0), "i" (_entry_1), "i" (_entry_2), "i" (_entry_3),
+              "i" (_entry_4), "i" (_entry_5), "i" (_entry_6), "i" (_entry_7),
+              "i" (_entry_8), "i" (_entry_9), "i" (_entry_10), "i" (_entry_11) /* input: entry points as immediates */
+            : /* clobbers: none */);
+    }
+
+    // Registry
+    inline void registry::install(void) {
+        // Write the registry_entry() function to the mtvec register in direct mode.
+        riscv::csrs.mtvec.write( reinterpret_cast<std::uintptr_t>(registry_entry) );
+    }
+
+    template<std::uint32_t CAUSE, class T> void registry::bind(T const &isr_handler) {
+        static_assert(CAUSE < VECTOR_TABLE_SIZE, "Interrupt cause is outside of the registry");
+        // The function and context must be updated together with respect to the ISR.
+        critical_section lock;
+        _bindings[CAUSE].execute = [](const void *context)
+            {
+                // Call into the function object.
+                static_cast<T const *>(context)->operator()();
+            };
+        _bindings[CAUSE].context = &isr_handler;
+    }
+
+    template<std::uint32_t CAUSE> void registry::unbind(void) {
+        static_assert(CAUSE < VECTOR_TABLE_SIZE, "Interrupt cause is outside of the registry");
+        critical_section lock;
+        _bindings[CAUSE].execute = unbound;
+        _bindings[CAUSE].context = nullptr;
+    }
+
+#pragma GCC push_options
+// Force the alignment for mtvec.BASE.
+#pragma GCC optimize ("align-functions=4")
+    void registry_entry(void)  {
+        // Dispatch by cause index within the registry class.
+        registry::dispatch();
+    }
+#pragma GCC pop_options
+}
+
+#endif // #ifndef IRQ_HPP
@@ -0,0 +1,159 @@
+/*
+   Interrupt latency and duration instrumentation.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Optional wrappers for interrupt handler function objects that measure:
+
+   - Duration : mcycle counts from entry to exit of the function object.
+   - Latency  : mcycle counts from the programmed mtimecmp deadline to entry of the
+                function object (timer interrupts only). The deadline is converted to
+                an mcycle count by driver::cycle_clock, which must be calibrated, and
+                synced periodically to bound the drift between mtime and mcycle.
+
+   e.g.
+       using hires_clock = driver::cycle_clock<decltype(mtimer)>;
+       hires_clock::calibrate(mtimer);
+       static irq::statistics<> isr_stats;
+       static const auto timed_handler = irq::instrument_timer<riscv::interrupts::mti, hires_clock>(isr_stats, mtimer, timer_handler);
+       irq::vectored_handler irq_handler(irq::make_vector<riscv::interrupts::mti>(timed_handler));
+       // In the idle loop
+       hires_clock::sync(mtimer);
+
+*/
+
+#ifndef IRQ_STATISTICS_HPP
+#define IRQ_STATISTICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// RISC-V CSR definitions and access classes
+#include "riscv-csr.hpp"
+
+// Interrupt vector definitions
+#include "irq.hpp"
+
+// mtime to mcycle conversion
+#include "cycle_clock.hpp"
+
+namespace irq {
+
+    /** Min/max/histogram statistics of a series of samples.
+        The histogram has power of two buckets, bucket N counts samples in [2^(N-1), 2^N).
+        The last bucket also counts all larger samples.
+     */
+    template<std::size_t BUCKETS> struct sample_statistics {
+        std::uint32_t count = 0;
+        std::uint32_t min = UINT32_MAX;
+        std::uint32_t max = 0;
+        std::uint32_t histogram[BUCKETS] = {};
+
+        /** Add a sample */
+        void add(std::uint32_t sample) {
+            count++;
+            if (sample < min) {
+                min = sample;
+            }
+            if (sample > max) {
+                max = sample;
+            }
+            histogram[bucket(sample)]++;
+        }
+        /** Reset all statistics */
+        void clear(void) {
+            *this = sample_statistics();
+        }
+        /** Histogram bucket for a sample, the number of significant bits. */
+        static constexpr std::size_t bucket(std::uint32_t sample) {
+            std::size_t bits = (sample == 0) ? 0 : (32 - __builtin_clz(sample));
+            return (bits < BUCKETS) ? bits : (BUCKETS - 1);
+        }
+    };
+
+    /** Per-cause interrupt statistics, held in a fixed buffer.
+        @tparam BUCKETS Number of histogram buckets for each statistic.
+     */
+    template<std::size_t BUCKETS=16> struct statistics {
+        /** Function object duration in mcycle counts */
+        sample_statistics<BUCKETS> duration[VECTOR_TABLE_SIZE];
+        /** Latency from the interrupt deadline in mcycle counts */
+        sample_statistics<BUCKETS> latency[VECTOR_TABLE_SIZE];
+
+        /** Reset all statistics */
+        void clear(void) {
+            for (auto &cause_stats : duration) {
+                cause_stats.clear();
+            }
+            for (auto &cause_stats : latency) {
+                cause_stats.clear();
+            }
+        }
+    };
+
+    /** Function object wrapper to measure the duration of an interrupt handler */
+    template<std::uint32_t CAUSE, class STATS, class T> class instrumented {
+    public:
+        static_assert(CAUSE < VECTOR_TABLE_SIZE, "Interrupt cause is outside of the statistics table");
+
+        instrumented(STATS &stats, T const &isr_handler)
+            : _stats(stats)
+            , _isr_handler(isr_handler) {}
+
+        void operator()(void) const {
+            std::uint32_t start = static_cast<std::uint32_t>(riscv::csrs.mcycle.read());
+            _isr_handler();
+            std::uint32_t end = static_cast<std::uint32_t>(riscv::csrs.mcycle.read());
+            // Unsigned subtraction handles the counter wrapping.
+            _stats.duration[CAUSE].add(end - start);
+        }
+    private:
+        STATS &_stats;
+        T const _isr_handler;
+    };
+
+    /** Function object wrapper to measure the latency and duration of a timer interrupt handler.
+        The latency is measured on entry, before the handler sets the next timer compare point.
+        @tparam CLOCK driver::cycle_clock type, converts the mtimecmp deadline to an mcycle count.
+     */
+    template<std::uint32_t CAUSE, class CLOCK, class STATS, class TIMER, class T> class instrumented_timer {
+    public:
+        static_assert(CAUSE < VECTOR_TABLE_SIZE, "Interrupt cause is outside of the statistics table");
+
+        instrumented_timer(STATS &stats, TIMER &timer, T const &isr_handler)
+            : _stats(stats)
+            , _timer(timer)
+            , _isr_handler(isr_handler) {}
+
+        void operator()(void) const {
+            std::uint32_t start = static_cast<std::uint32_t>(riscv::csrs.mcycle.read());
+            // The interrupt is raised at the start of the deadline tick.
+            std::uint32_t deadline = static_cast<std::uint32_t>(CLOCK::tick_cycles(static_cast<std::uint32_t>(_timer.get_raw_time_cmp())));
+            // Unsigned subtraction handles the counter wrapping, an early entry (alignment error) counts as 0.
+            std::uint32_t latency = start - deadline;
+            _stats.latency[CAUSE].add((static_cast<std::int32_t>(latency) < 0) ? 0 : latency);
+            _isr_handler();
+            std::uint32_t end = static_cast<std::uint32_t>(riscv::csrs.mcycle.read());
+            _stats.duration[CAUSE].add(end - start);
+        }
+    private:
+        STATS &_stats;
+        TIMER &_timer;
+        T const _isr_handler;
+    };
+
+    /** Wrap an interrupt handler to measure its duration. */
+    template<std::uint32_t CAUSE, class STATS, class T> instrumented<CAUSE, STATS, T> instrument(STATS &stats, T const &isr_handler) {
+        return instrumented<CAUSE, STATS, T>(stats, isr_handler);
+    }
+
+    /** Wrap a timer interrupt handler to measure its latency and duration.
+        @tparam CLOCK driver::cycle_clock type calibrated against the timer.
+     */
+    template<std::uint32_t CAUSE, class CLOCK, class STATS, class TIMER, class T> instrumented_timer<CAUSE, CLOCK, STATS, TIMER, T> instrument_timer(STATS &stats, TIMER &timer, T const &isr_handler) {
+        return instrumented_timer<CAUSE, CLOCK, STATS, TIMER, T>(stats, timer, isr_handler);
+    }
+}
+
+#endif // #ifndef IRQ_STATISTICS_HPP
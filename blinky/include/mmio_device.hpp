@@ -6,6 +6,13 @@
 #define MMIO_DEVICE_HPP
 
 #include <cstdint>
+#include <type_traits>
+
+// Register width on host builds
+#include "platform.hpp"
+
+// Critical sections for atomic operations without the A extension
+#include "critical_section.hpp"
 
 namespace mmio_device {
 
@@ -42,6 +49,177 @@ namespace mmio_device {
         }; 
     };
 
+/** Atomic read-modify-write operations */
+enum class atomic_op {
+    swap,
+    and_bits,
+    or_bits,
+    xor_bits,
+};
+
+/** The result of a read-modify-write operation */
+template<atomic_op OP, class T> constexpr T apply(T current, T value) {
+    if constexpr (OP == atomic_op::swap) {
+        return value;
+    } else if constexpr (OP == atomic_op::and_bits) {
+        return current & value;
+    } else if constexpr (OP == atomic_op::or_bits) {
+        return current | value;
+    } else {
+        return current ^ value;
+    }
+}
+
+#define MMIO_DEVICE_AMO(INSN)                                       \
+    __asm__ volatile (INSN "    %0, %2, (%1)"                       \
+                      : "=r" (previous)  /* output: register %0 */ \
+                      : "r" (addr), "r" (value) /* input */         \
+                      : "memory")
+
+/** AMO instruction on a 32 bit word, or 64 bit double word on RV64.
+    Requires the A extension, only instantiated when __riscv_atomic is defined.
+    @retval The previous value at addr.
+ */
+template<atomic_op OP, class T> T amo(uintptr_t addr, T value) {
+    T previous;
+    if constexpr (sizeof(T) == 8) {
+        if constexpr (OP == atomic_op::swap) {
+            MMIO_DEVICE_AMO("amoswap.d");
+        } else if constexpr (OP == atomic_op::and_bits) {
+            MMIO_DEVICE_AMO("amoand.d");
+        } else if constexpr (OP == atomic_op::or_bits) {
+            MMIO_DEVICE_AMO("amoor.d");
+        } else {
+            MMIO_DEVICE_AMO("amoxor.d");
+        }
+    } else {
+        if constexpr (OP == atomic_op::swap) {
+            MMIO_DEVICE_AMO("amoswap.w");
+        } else if constexpr (OP == atomic_op::and_bits) {
+            MMIO_DEVICE_AMO("amoand.w");
+        } else if constexpr (OP == atomic_op::or_bits) {
+            MMIO_DEVICE_AMO("amoor.w");
+        } else {
+            MMIO_DEVICE_AMO("amoxor.w");
+        }
+    }
+    return previous;
+}
+
+#undef MMIO_DEVICE_AMO
+
+/** Atomic read-modify-write of the register at ADDR.
+    - 32 bit registers (and 64 bit on RV64) use a single AMO instruction.
+    - 8 and 16 bit and/or/xor use a 32 bit AMO on the aligned word, with the other bytes unchanged.
+    - Otherwise, or without the A extension, interrupts are disabled around a read-modify-write.
+    @retval The previous value of the register.
+ */
+template<atomic_op OP, uintptr_t ADDR, class T> T atomic_rmw(T value) {
+#ifdef __riscv_atomic
+    constexpr bool native_amo = (sizeof(T) == 4) || ((sizeof(T) == 8) && (__riscv_xlen == 64));
+    constexpr bool word_amo = (sizeof(T) < 4) && (OP != atomic_op::swap);
+#else
+    constexpr bool native_amo = false;
+    constexpr bool word_amo = false;
+#endif
+    if constexpr (native_amo) {
+        return amo<OP, T>(ADDR, value);
+    } else if constexpr (word_amo) {
+        constexpr uintptr_t word_addr = ADDR & ~static_cast<uintptr_t>(3);
+        constexpr unsigned int shift = (ADDR & 3) * 8;
+        constexpr std::uint32_t lane = ((static_cast<std::uint32_t>(1) << (8*sizeof(T))) - 1) << shift;
+        std::uint32_t word_value = static_cast<std::uint32_t>(value) << shift;
+        if constexpr (OP == atomic_op::and_bits) {
+            // Keep the other bytes of the word
+            word_value |= ~lane;
+        }
+        return static_cast<T>(amo<OP, std::uint32_t>(word_addr, word_value) >> shift);
+    } else {
+        irq::critical_section lock;
+        volatile T *reg = reinterpret_cast<volatile T*>(ADDR);
+        const T previous = *reg;
+        *reg = apply<OP>(previous, value);
+        return previous;
+    }
+}
+
+/** Register access policy: Direct volatile access to the register.
+    Read-modify-write operations read the register from the bus.
+ */
+template<uintptr_t ADDR, class T> struct direct_access {
+    /** Read-modify-write operations access the bus. */
+    static constexpr bool shadowed = false;
+
+    static void write(T value) {
+        *reinterpret_cast<volatile T*>(ADDR) = value;
+    }
+    static T read(void) {
+        return *reinterpret_cast<volatile T*>(ADDR);
+    }
+    /** The value modified by a read-modify-write. */
+    static T read_for_modify(void) {
+        return read();
+    }
+    /** Atomic read-modify-write, returns the previous value. */
+    template<atomic_op OP> static T atomic(T value) {
+        return atomic_rmw<OP, ADDR, T>(value);
+    }
+};
+
+/** Register access policy: Shadow register.
+    Keeps a RAM copy of the last value written, read-modify-write operations use the copy
+    and become a single bus write. Use for write-mostly registers that are not modified by hardware,
+    e.g. GPIO output value and output enable.
+    The copy is shared by all instances of the register at the same address.
+    It starts at 0, the reset value of most registers. Call sync() if the register
+    was written by other code, e.g. a boot loader. The generated devices call sync()
+    for their shadowed registers when they are constructed.
+ */
+template<uintptr_t ADDR, class T> struct shadow_access {
+    /** Read-modify-write operations are a single bus write. */
+    static constexpr bool shadowed = true;
+
+    static void write(T value) {
+        _shadow = value;
+        *reinterpret_cast<volatile T*>(ADDR) = value;
+    }
+    static T read(void) {
+        return *reinterpret_cast<volatile T*>(ADDR);
+    }
+    /** The value modified by a read-modify-write, the RAM copy. No bus access. */
+    static T read_for_modify(void) {
+        return _shadow;
+    }
+    /** Reload the RAM copy from the register. */
+    static void sync(void) {
+        _shadow = read();
+    }
+    /** The RAM copy, for code that takes the register at run time. */
+    static T *copy(void) {
+        return &_shadow;
+    }
+    /** Atomic read-modify-write, returns the previous value.
+        The RAM copy and register are updated together, so interrupts are disabled for the single write.
+     */
+    template<atomic_op OP> static T atomic(T value) {
+        irq::critical_section lock;
+        const T previous = _shadow;
+        write(apply<OP>(previous, value));
+        return previous;
+    }
+private:
+    static inline T _shadow = 0;
+};
+
+/** A field value formatted for register R, the operand of reg::modify().
+    The mask is known at compile time, the value is masked and located at the field bit offset.
+ */
+template<class R, class F> struct field_value {
+    using register_t = R;
+    static constexpr typename R::datatype mask = F::bit_mask;
+    typename R::datatype value;
+};
+
 /** Base class for all MMIO registers.
 
     Class R should define the following type:
@@ -52,36 +230,78 @@ namespace mmio_device {
     
     offset   - Byte offset from BASE_ADDR for register
 
+    Template ACCESS is the access policy, direct_access or shadow_access.
+
  */
-template<uintptr_t BASE_ADDR, class R> class reg {
+template<uintptr_t BASE_ADDR, class R,
+         template<uintptr_t, class> class ACCESS=direct_access> class reg {
     public :
 
     using datatype_t = typename R::datatype;
+    using access_t = ACCESS<BASE_ADDR + R::offset, datatype_t>;
+    /** Bus address of the register */
+    static constexpr uintptr_t address = BASE_ADDR + R::offset;
     
     void write(datatype_t value) {
-        *reinterpret_cast<volatile datatype_t*>(BASE_ADDR + R::offset) = value;
+        access_t::write(value);
     }
+    /** Atomically set bits. Safe to use from interrupt handlers. */
     void set(datatype_t value) { 
-        *reinterpret_cast<volatile datatype_t*>(BASE_ADDR + R::offset) |= value;
+        access_t::template atomic<atomic_op::or_bits>(value);
     }
+    /** Atomically clear bits. Safe to use from interrupt handlers. */
     void clr(datatype_t value) { 
-        *reinterpret_cast<volatile datatype_t*>(BASE_ADDR + R::offset) &= ~value;
+        access_t::template atomic<atomic_op::and_bits>(static_cast<datatype_t>(~value));
+    }
+    /** Atomically invert bits. Safe to use from interrupt handlers. */
+    void toggle(datatype_t value) { 
+        access_t::template atomic<atomic_op::xor_bits>(value);
+    }
+    /** Atomically write the register.
+        @retval The previous value of the register.
+     */
+    datatype_t swap(datatype_t value) { 
+        return access_t::template atomic<atomic_op::swap>(value);
     }
     datatype_t read(void) {
-        return *reinterpret_cast<volatile datatype_t*>(BASE_ADDR + R::offset);
+        return access_t::read();
+    }
+    /** Reload the RAM copy of a shadowed register from the bus. No effect with other access policies. */
+    void sync(void) {
+        if constexpr (access_t::shadowed) {
+            access_t::sync();
+        }
     }
     datatype_t operator=(datatype_t value) {
         write(value);
-        return read();
+        return access_t::read_for_modify();
     }
     void operator&=(datatype_t value) {
-        write(read()&value);
+        access_t::write(access_t::read_for_modify()&value);
     }
     void operator|=(datatype_t value) {
-        write(read()|value);
+        access_t::write(access_t::read_for_modify()|value);
     }
     void operator^=(datatype_t value) {
-        write(read()^value);
+        access_t::write(access_t::read_for_modify()^value);
+    }
+    /** Write several fields with a single read-modify-write.
+        e.g. reg.modify(reg.field_a.value(x), reg.field_b.value(y))
+        The field masks are merged at compile time. If the fields cover the whole register
+        the register is written without a read.
+     */
+    template<class... FIELDS> void modify(FIELDS... fields) {
+        static_assert((std::is_same_v<typename FIELDS::register_t, R> && ...), "The fields must belong to this register");
+        constexpr datatype_t mask = (FIELDS::mask | ... | 0);
+        constexpr datatype_t all_bits = (R::bit_width >= (8*sizeof(datatype_t)))
+            ? static_cast<datatype_t>(~static_cast<datatype_t>(0))
+            : static_cast<datatype_t>((static_cast<datatype_t>(1) << R::bit_width) - 1);
+        const datatype_t value = (fields.value | ... | 0);
+        if constexpr (mask == all_bits) {
+            access_t::write(value);
+        } else {
+            access_t::write((access_t::read_for_modify() & ~mask) | value);
+        }
     }
 };
 
@@ -98,13 +318,27 @@ template<uintptr_t BASE_ADDR, class R> class reg {
     bit_mask   - A mask for the location of the field within the parent register.
     bit_offset - The LSB of the field.
 
+    Template ACCESS is the access policy of the parent register.
 
  */
-template<uintptr_t BASE_ADDR, class R, class F> class reg_field {
+template<uintptr_t BASE_ADDR, class R, class F,
+         template<uintptr_t, class> class ACCESS=direct_access> class reg_field {
     public :
 
     using r_datatype_t = typename R::datatype;
     using f_datatype_t = typename F::datatype;
+    using access_t = ACCESS<BASE_ADDR + R::offset, r_datatype_t>;
+
+    /** Format a field value for reg::modify(), e.g. reg.modify(reg.field_a.value(x), reg.field_b.value(y)).
+        Does not write to hardware.
+     */
+    [[nodiscard]] constexpr field_value<R, F> value(f_datatype_t value) const {
+        return field_value<R, F>{static_cast<r_datatype_t>(((r_datatype_t)value << F::bit_offset) & F::bit_mask)};
+    }
+    /** Write to a field, the same as write(). */
+    void operator=(f_datatype_t value) {
+        write(value);
+    }
 
     /** Return the mask for this field. */
     constexpr r_datatype_t mask(void) const {
@@ -132,32 +366,50 @@ template<uintptr_t BASE_ADDR, class R, class F> class reg_field {
     void write(f_datatype_t value) {
         if constexpr ((R::bit_width == F::bit_width) && (F::bit_offset == 0)) {
            // Write to single bit.
-           *reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset) = (r_datatype_t) value ;
+           access_t::write((r_datatype_t) value);
         } else if constexpr (R::field_count == 1) {
            // Write to single field.
-           *reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset) = 
-               ((r_datatype_t)value << F::bit_offset) & F::bit_mask;
+           access_t::write(((r_datatype_t)value << F::bit_offset) & F::bit_mask);
         } else {
             // Read write modify
-            r_datatype_t reg_value = *reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset);
+            r_datatype_t reg_value = access_t::read_for_modify();
             reg_value = (((r_datatype_t)value << F::bit_offset) & F::bit_mask) | (reg_value & ~F::bit_mask);
-            *reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset) = reg_value;
+            access_t::write(reg_value);
         }
     }
-    /** Set all the bits in this field. */
+    /** Set all the bits in this field. Atomic, safe to use from interrupt handlers. */
     void set(void) {
         if constexpr (R::field_count == 1) {
-                *reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset) = F::bit_mask;
+                access_t::write(F::bit_mask);
         } else {
-                *reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset) |= F::bit_mask;
+                access_t::template atomic<atomic_op::or_bits>(F::bit_mask);
         }
     }
-    /** Clear all the bits in this field. */
+    /** Clear all the bits in this field. Atomic, safe to use from interrupt handlers. */
     void clear(void) {
         if constexpr (R::field_count == 1) {
-                *reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset) = 0;
+                access_t::write(0);
+        } else {
+                access_t::template atomic<atomic_op::and_bits>(static_cast<r_datatype_t>(~F::bit_mask));
+        }
+    }
+    /** Invert all the bits in this field. Atomic, safe to use from interrupt handlers. */
+    void toggle(void) {
+        access_t::template atomic<atomic_op::xor_bits>(F::bit_mask);
+    }
+    /** Atomically write the field.
+        A single AMO if the field occupies the whole register, otherwise interrupts are disabled
+        around the read-modify-write.
+        @retval The previous value of the field.
+     */
+    f_datatype_t swap(f_datatype_t value) {
+        if constexpr ((R::bit_width == F::bit_width) && (F::bit_offset == 0)) {
+            return (f_datatype_t) access_t::template atomic<atomic_op::swap>((r_datatype_t) value);
         } else {
-                *reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset) &= ~F::bit_mask;
+            irq::critical_section lock;
+            const r_datatype_t reg_value = access_t::read_for_modify();
+            access_t::write((((r_datatype_t)value << F::bit_offset) & F::bit_mask) | (reg_value & ~F::bit_mask));
+            return (f_datatype_t) ((reg_value & F::bit_mask) >> F::bit_offset);
         }
     }
     /** Read the field.
@@ -165,9 +417,9 @@ template<uintptr_t BASE_ADDR, class R, class F> class reg_field {
      */
     f_datatype_t read(void) {
         if constexpr ((R::bit_width == F::bit_width) && (F::bit_offset == 0)) {
-            return (f_datatype_t) *reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset);
+            return (f_datatype_t) access_t::read();
         } else {
-            return (f_datatype_t) ((*reinterpret_cast<volatile r_datatype_t*>(BASE_ADDR + R::offset)) & F::bit_mask)  >> F::bit_offset;
+            return (f_datatype_t) ((access_t::read() & F::bit_mask) >> F::bit_offset);
         }
     }
     /** Read the field after writing the register using an 'OR' atomic operation.
@@ -0,0 +1,148 @@
+/*
+   Simulated MMIO register file for host builds.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   An MMIO access policy that maps register addresses onto a simulated
+   register file, so drivers can compile and run natively on a host for
+   testing and benchmarking. Hooks model the hardware side of a register,
+   e.g. an advancing mtime counter.
+
+   Host only, uses dynamic memory allocation and std::function.
+
+   e.g.
+       using sim_timer = driver::timer<driver::mtimer_address_spec, driver::default_timer_config, mmio_sim::sim_access>;
+       auto &regs = mmio_sim::register_file::instance();
+       std::uint64_t now = 0;
+       regs.on_read(driver::mtimer_address_spec::MTIME_ADDR, [&] (std::uintptr_t) {
+           regs.poke<std::uint64_t>(driver::mtimer_address_spec::MTIME_ADDR, now);
+       });
+       sim_timer mtimer;
+       driver::sifive_gpio0_0_dev<0x10012000, mmio_sim::sim_access, mmio_sim::sim_access> gpio_dev;
+
+*/
+
+#ifndef MMIO_SIM_HPP
+#define MMIO_SIM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+// MMIO register access policies
+#include "mmio_device.hpp"
+
+namespace mmio_sim {
+
+    /** Simulated register file. Byte addressed, so overlapping accesses of different widths are consistent
+        (e.g. the 64 bit mtime and its 32 bit halves). Unwritten bytes read as 0.
+     */
+    class register_file {
+    public:
+        /** Called before a register is read, may update the register with poke(). */
+        using read_hook = std::function<void(std::uintptr_t addr)>;
+        /** Called after a register is written, with the value written. */
+        using write_hook = std::function<void(std::uintptr_t addr, std::uint64_t value)>;
+
+        /** The register file shared by all sim_access registers. */
+        static register_file &instance(void) {
+            static register_file regs;
+            return regs;
+        }
+
+        /** Bus read, calls the read hook. */
+        template<class T> T read(std::uintptr_t addr) {
+            _reads++;
+            auto hook = _read_hooks.find(addr);
+            if (hook != _read_hooks.end()) {
+                hook->second(addr);
+            }
+            return peek<T>(addr);
+        }
+        /** Bus write, calls the write hook. */
+        template<class T> void write(std::uintptr_t addr, T value) {
+            _writes++;
+            poke<T>(addr, value);
+            auto hook = _write_hooks.find(addr);
+            if (hook != _write_hooks.end()) {
+                hook->second(addr, value);
+            }
+        }
+
+        /** Read the register file without a bus access. */
+        template<class T> T peek(std::uintptr_t addr) const {
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < sizeof(T); i++) {
+                auto byte = _bytes.find(addr + i);
+                if (byte != _bytes.end()) {
+                    value |= static_cast<std::uint64_t>(byte->second) << (8*i);
+                }
+            }
+            return static_cast<T>(value);
+        }
+        /** Write the register file without a bus access, e.g. to model hardware updating a register. */
+        template<class T> void poke(std::uintptr_t addr, T value) {
+            for (std::size_t i = 0; i < sizeof(T); i++) {
+                _bytes[addr + i] = static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (8*i));
+            }
+        }
+
+        void on_read(std::uintptr_t addr, read_hook hook) {
+            _read_hooks[addr] = hook;
+        }
+        void on_write(std::uintptr_t addr, write_hook hook) {
+            _write_hooks[addr] = hook;
+        }
+
+        /** Number of bus reads and writes, e.g. to compare the bus traffic of access policies. */
+        std::size_t reads(void) const {
+            return _reads;
+        }
+        std::size_t writes(void) const {
+            return _writes;
+        }
+
+        /** Clear all registers, hooks and counters. */
+        void reset(void) {
+            _bytes.clear();
+            _read_hooks.clear();
+            _write_hooks.clear();
+            _reads = 0;
+            _writes = 0;
+        }
+
+    private:
+        std::unordered_map<std::uintptr_t, std::uint8_t> _bytes;
+        std::unordered_map<std::uintptr_t, read_hook> _read_hooks;
+        std::unordered_map<std::uintptr_t, write_hook> _write_hooks;
+        std::size_t _reads = 0;
+        std::size_t _writes = 0;
+    };
+
+    /** Register access policy: Simulated register file.
+        Same interface as mmio_device::direct_access.
+     */
+    template<std::uintptr_t ADDR, class T> struct sim_access {
+        static constexpr bool shadowed = false;
+
+        static void write(T value) {
+            register_file::instance().write<T>(ADDR, value);
+        }
+        static T read(void) {
+            return register_file::instance().read<T>(ADDR);
+        }
+        static T read_for_modify(void) {
+            return read();
+        }
+        /** The simulation is single threaded, so a read and write is atomic. */
+        template<mmio_device::atomic_op OP> static T atomic(T value) {
+            const T previous = read();
+            write(mmio_device::apply<OP>(previous, value));
+            return previous;
+        }
+    };
+}
+
+#endif // #ifndef MMIO_SIM_HPP
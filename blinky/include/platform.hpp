@@ -0,0 +1,21 @@
+/*
+   Target platform definitions.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Host builds (e.g. with the simulated MMIO of mmio_sim.hpp) do not have the
+   RISC-V predefined macros. The register width falls back to the host
+   pointer width, and can be set with -D__riscv_xlen=32 to build the RV32
+   code paths on a 64 bit host.
+
+*/
+
+#ifndef PLATFORM_HPP
+#define PLATFORM_HPP
+
+#ifndef __riscv_xlen
+#define __riscv_xlen (__SIZEOF_POINTER__ * 8)
+#endif
+
+#endif // #ifndef PLATFORM_HPP
@@ -0,0 +1,150 @@
+/*
+   Platform-Level Interrupt Controller (PLIC) driver.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   The PLIC multiplexes the external interrupt sources onto the machine external
+   interrupt (riscv::interrupts::mei). Function objects are bound to each source
+   ID, the mei handler claims the highest priority pending source, calls the bound
+   function object and completes the source.
+
+   e.g.
+       driver::riscv_plic0_dev<RISCV_PLIC0> plic_dev;
+       driver::plic<decltype(plic_dev)> plic(plic_dev);
+       plic.bind<UART0_SOURCE>(uart_handler);
+       plic.enable<UART0_SOURCE>(1);
+       static const auto external_handler = [&] (void) { plic.dispatch(); };
+       irq::vectored_handler irq_handler(irq::make_vector<riscv::interrupts::mei>(external_handler));
+       riscv::csrs.mie.mei.set();
+
+*/
+
+#ifndef PLIC_HPP
+#define PLIC_HPP
+
+#include <cstdint>
+
+// Critical sections
+#include "critical_section.hpp"
+
+// Compile time bit masks
+#include "util.hpp"
+
+namespace driver {
+
+    /** SiFive-hifive1-revb PLIC parameters
+     */
+    struct default_plic_config {
+        // See
+        // freedom-e-sdk/bsp/sifive-hifive1-revb/core.dts
+        // interrupt-controller@c000000: riscv,ndev = <52>
+        // Source ID 0 is reserved for "no interrupt".
+        static constexpr unsigned int SOURCE_COUNT=53;
+        // 3 bit priority, 0 never interrupts.
+        static constexpr unsigned int MAX_PRIORITY=7;
+    };
+
+    /** PLIC driver for hart 0 machine mode.
+        @tparam DEV    PLIC device type, e.g. riscv_plic0_dev<BASE_ADDR>
+        @tparam CONFIG Number of sources and priority levels.
+     */
+    template<class DEV, class CONFIG=default_plic_config> class plic {
+    public:
+        explicit plic(DEV &dev)
+            : _dev(dev) {
+            // Allow all priorities, sources are enabled individually.
+            _dev.threshold.write(0);
+        }
+        // Boilerplate delete defaults - non copyable class
+        plic(const plic&) = delete;
+        plic &operator=(const plic&) = delete;
+        plic(plic&&) = delete;
+        plic &operator=(plic&&) = delete;
+
+        /** Bind a function object to an interrupt source.
+            This is defined as a template to prevent dynamic memory allocation. */
+        template<unsigned int SOURCE, class T> void bind(T const &isr_handler) {
+            check_source<SOURCE>();
+            // The function and context must be updated together with respect to the ISR.
+            irq::critical_section lock;
+            _bindings[SOURCE].execute = [](const void *context)
+                {
+                    // Call into the function object.
+                    static_cast<T const *>(context)->operator()();
+                };
+            _bindings[SOURCE].context = &isr_handler;
+        }
+        /** Remove the binding for an interrupt source. */
+        template<unsigned int SOURCE> void unbind(void) {
+            check_source<SOURCE>();
+            irq::critical_section lock;
+            _bindings[SOURCE].execute = nullptr;
+            _bindings[SOURCE].context = nullptr;
+        }
+
+        /** Set the priority of a source and enable it. */
+        template<unsigned int SOURCE> void enable(unsigned int priority) {
+            set_priority<SOURCE>(priority);
+            _dev.template enable<SOURCE/32>.set(util::bitmask(SOURCE%32));
+        }
+        /** Disable a source. */
+        template<unsigned int SOURCE> void disable(void) {
+            check_source<SOURCE>();
+            _dev.template enable<SOURCE/32>.clr(util::bitmask(SOURCE%32));
+        }
+        /** Set the priority of a source, 0 disables the source. */
+        template<unsigned int SOURCE> void set_priority(unsigned int priority) {
+            check_source<SOURCE>();
+            _dev.template priority<SOURCE>.write((priority > CONFIG::MAX_PRIORITY) ? CONFIG::MAX_PRIORITY : priority);
+        }
+        /** Only sources with a priority above the threshold interrupt the hart. */
+        void set_threshold(unsigned int threshold) {
+            _dev.threshold.write((threshold > CONFIG::MAX_PRIORITY) ? CONFIG::MAX_PRIORITY : threshold);
+        }
+
+        /** Claim the highest priority pending source.
+            @retval The source ID, or 0 if no source is pending.
+         */
+        std::uint32_t claim(void) {
+            return _dev.claim.read();
+        }
+        /** Signal the handling of a claimed source is complete. */
+        void complete(std::uint32_t source) {
+            _dev.claim.write(source);
+        }
+
+        /** Claim, handle and complete all pending sources. Called from the mei handler.
+            The bound function object must clear the interrupt condition in the device
+            before returning, or the source is pending again after completion.
+         */
+        void dispatch(void) {
+            for (std::uint32_t source = claim(); source != 0; source = claim()) {
+                if (source < CONFIG::SOURCE_COUNT) {
+                    binding const &this_binding = _bindings[source];
+                    if (this_binding.execute) {
+                        this_binding.execute(this_binding.context);
+                    }
+                }
+                complete(source);
+            }
+        }
+
+    private:
+        DEV &_dev;
+
+        template<unsigned int SOURCE> static constexpr void check_source(void) {
+            static_assert((SOURCE > 0) && (SOURCE < CONFIG::SOURCE_COUNT), "Invalid PLIC source ID");
+        }
+
+        /** Type erased function object call */
+        struct binding {
+            void (*execute)(const void *context);
+            const void *context;
+        };
+        // Zero initialized, sources with no bound function object have a null execute pointer.
+        static inline binding _bindings[CONFIG::SOURCE_COUNT] = {};
+    };
+}
+
+#endif // #ifndef PLIC_HPP
@@ -0,0 +1,179 @@
+/*
+   Power, reset, clock and interrupt (PRCI) driver for the FE310.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Runs the core from the PLL. The PLL divisors are found by a constexpr
+   solver and checked against the PLL limits at compile time:
+
+       hfclk = HFXOSC_HZ / R * F / Q / OUTDIV
+
+   - R      : 1 to 4, the PLL reference (HFXOSC_HZ / R) must be 6 to 12MHz.
+   - F      : 2 to 128 (even), the VCO (reference * F) must be 384 to 768MHz.
+   - Q      : 2, 4 or 8, the PLL output (VCO / Q) must be 48 to 384MHz.
+   - OUTDIV : 1, or 2 to 128 (even).
+
+   e.g.
+       using clock_config = driver::pll_clock_config<320000000>;
+       driver::timer<driver::mtimer_address_spec, clock_config> mtimer;
+       driver::prci<PRCI_ADDR> prci;
+       prci.use_pll<clock_config>(mtimer);
+
+*/
+
+#ifndef PRCI_HPP
+#define PRCI_HPP
+
+#include <cstdint>
+
+// MMIO register access policies
+#include "mmio_device.hpp"
+
+// Clock tree configuration
+#include "clock_config.hpp"
+
+// MMIO Device interface definition, generated by tools/svd2mmio.py
+#include "device/sifive_fe310_g000_prci_mmio_dev.hpp"
+
+namespace driver {
+
+    /** PLL divisors */
+    struct pll_settings {
+        std::uint32_t r;
+        std::uint32_t f;
+        std::uint32_t q;
+        std::uint32_t outdiv;
+        // Output frequency, 0 if no divisors are valid
+        std::uint32_t frequency;
+    };
+
+    /** Find the PLL divisors with an output closest to, and not above, the target frequency.
+        The smallest error is preferred, then the lowest VCO frequency.
+     */
+    constexpr pll_settings solve_pll(std::uint32_t reference_hz, std::uint32_t target_hz) {
+        pll_settings best{0, 0, 0, 0, 0};
+        std::uint64_t best_vco = 0;
+        for (std::uint32_t r = 1; r <= 4; r++) {
+            const std::uint64_t refr = reference_hz / r;
+            if ((refr * r != reference_hz) || (refr < 6000000) || (refr > 12000000)) {
+                continue;
+            }
+            for (std::uint32_t f = 2; f <= 128; f += 2) {
+                const std::uint64_t vco = refr * f;
+                if ((vco < 384000000) || (vco > 768000000)) {
+                    continue;
+                }
+                for (std::uint32_t q = 2; q <= 8; q *= 2) {
+                    const std::uint64_t pllout = vco / q;
+                    if ((pllout < 48000000) || (pllout > 384000000)) {
+                        continue;
+                    }
+                    for (std::uint32_t outdiv = 1; outdiv <= 128; outdiv = (outdiv == 1) ? 2 : outdiv + 2) {
+                        const std::uint64_t out = pllout / outdiv;
+                        if ((out > target_hz) || (out < best.frequency)
+                            || ((out == best.frequency) && (vco >= best_vco) && (best.frequency != 0))) {
+                            continue;
+                        }
+                        best = pll_settings{r, f, q, outdiv, static_cast<std::uint32_t>(out)};
+                        best_vco = vco;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    /** Clock configuration with the core clock from the PLL.
+        @tparam TARGET_HZ Requested core clock, the actual CORE_CLOCK_HZ may be lower.
+        @tparam BASE      Board clocks, the PLL reference is BASE::HFXOSC_HZ.
+     */
+    template<std::uint32_t TARGET_HZ, class BASE=default_clock_config> struct pll_clock_config : BASE {
+        static_assert(TARGET_HZ <= BASE::MAX_CORE_CLOCK_HZ, "The core clock is above the maximum frequency");
+
+        static constexpr pll_settings PLL = solve_pll(BASE::HFXOSC_HZ, TARGET_HZ);
+        static_assert(PLL.frequency != 0, "No PLL divisors for the core clock");
+
+        static constexpr std::uint32_t CORE_CLOCK_HZ = PLL.frequency;
+    };
+
+    /** PRCI driver.
+        Template ACCESS is the MMIO access policy, e.g. mmio_device::direct_access, or mmio_sim::sim_access on a host.
+     */
+    template<std::uintptr_t BASE_ADDR,
+             template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class prci {
+    public:
+        /** PLL lock indication is not valid until this time after the PLL is configured */
+        static constexpr std::uint32_t PLL_LOCK_DELAY_US = 100;
+
+        prci(void) {}
+        // Boilerplate delete defaults - non copyable class
+        prci(const prci&) = delete;
+        prci &operator=(const prci&) = delete;
+        prci(prci&&) = delete;
+        prci &operator=(prci&&) = delete;
+
+        /** Run the core from the PLL, configured by CLOCK::PLL.
+            The core runs from the internal oscillator while the PLL locks.
+            @param timer The mtime timer, used for the PLL lock delay.
+            @note Peripheral clock dividers (UART, PWM, QSPI) use the new core clock after this call.
+         */
+        template<class CLOCK, class TIMER> void use_pll(TIMER &timer) {
+            constexpr pll_settings pll = CLOCK::PLL;
+            use_hfrosc();
+            enable_hfxosc();
+            // The PLL settings may only be changed while the PLL is not selected.
+            _dev.pllcfg.modify(_dev.pllcfg.pllr.value(pll.r - 1),
+                               _dev.pllcfg.pllf.value(pll.f/2 - 1),
+                               _dev.pllcfg.pllq.value((pll.q == 2) ? 1 : ((pll.q == 4) ? 2 : 3)),
+                               _dev.pllcfg.pllsel.value(false),
+                               _dev.pllcfg.pllrefsel.value(true),
+                               _dev.pllcfg.pllbypass.value(false));
+            if constexpr (pll.outdiv == 1) {
+                _dev.plloutdiv.modify(_dev.plloutdiv.div.value(0),
+                                      _dev.plloutdiv.divby1.value(true));
+            } else {
+                _dev.plloutdiv.modify(_dev.plloutdiv.div.value(pll.outdiv/2 - 1),
+                                      _dev.plloutdiv.divby1.value(false));
+            }
+            // Ignore the lock indication for the first 100us, then wait for lock.
+            constexpr std::uint32_t lock_ticks = (PLL_LOCK_DELAY_US * CLOCK::MTIME_FREQ_HZ + 999999) / 1000000 + 1;
+            const std::uint32_t start = timer.get_raw_time_short();
+            while ((timer.get_raw_time_short() - start) < lock_ticks) {
+            }
+            while (!_dev.pllcfg.plllock.read()) {
+            }
+            _dev.pllcfg.pllsel.set();
+        }
+
+        /** Run the core directly from the crystal oscillator, the PLL is bypassed. */
+        void use_hfxosc(void) {
+            use_hfrosc();
+            enable_hfxosc();
+            _dev.pllcfg.modify(_dev.pllcfg.pllsel.value(false),
+                               _dev.pllcfg.pllrefsel.value(true),
+                               _dev.pllcfg.pllbypass.value(true));
+            _dev.plloutdiv.modify(_dev.plloutdiv.div.value(0),
+                                  _dev.plloutdiv.divby1.value(true));
+            _dev.pllcfg.pllsel.set();
+        }
+
+    private:
+        sifive_fe310_g000_prci_dev<BASE_ADDR, ACCESS> _dev;
+
+        /** Run the core from the internal oscillator, so the PLL can be changed. */
+        void use_hfrosc(void) {
+            _dev.hfrosccfg.hfroscen.set();
+            while (!_dev.hfrosccfg.hfroscrdy.read()) {
+            }
+            _dev.pllcfg.pllsel.clear();
+        }
+        void enable_hfxosc(void) {
+            _dev.hfxosccfg.hfxoscen.set();
+            while (!_dev.hfxosccfg.hfxoscrdy.read()) {
+            }
+        }
+    };
+}
+
+#endif // #ifndef PRCI_HPP
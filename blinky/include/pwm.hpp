@@ -0,0 +1,162 @@
+/*
+   PWM driver for the sifive_pwm0 device.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Waveforms are generated by the PWM hardware, no interrupts or CPU time are
+   needed once the period and duty are set.
+
+   Comparator 0 sets the period, comparators 1 to 3 set the duty of the three
+   outputs. The periods and duties are std::chrono durations, converted to the
+   counter scale and compare values by constexpr functions, so constant
+   durations are resolved at compile time.
+
+   e.g.
+       using led_pwm_t = driver::pwm<SIFIVE_PWM0_1>;
+       constexpr auto led_timing = led_pwm_t::timing(std::chrono::milliseconds{10});
+       led_pwm_t led_pwm(led_timing);
+       led_pwm.set_duty<1>(std::chrono::milliseconds{1});
+       led_pins.iof<1>();
+
+*/
+
+#ifndef PWM_HPP
+#define PWM_HPP
+
+#include <cstdint>
+#include <chrono>
+
+// MMIO register access policies
+#include "mmio_device.hpp"
+
+// Clock tree configuration
+#include "clock_config.hpp"
+
+// MMIO Device interface definition, generated by tools/svd2mmio.py
+#include "device/sifive_pwm0_0_mmio_dev.hpp"
+
+namespace driver {
+
+    /** PWM parameters.
+        The PWM is clocked by tlclk, CLOCK::CORE_CLOCK_HZ.
+        @tparam CLOCK     Clock configuration, e.g. driver::pll_clock_config<>.
+        @tparam WIDTH     Comparator width.
+     */
+    template<class CLOCK=default_clock_config, unsigned int WIDTH=16> struct pwm_config : CLOCK {
+        static constexpr unsigned int CMP_WIDTH=WIDTH;
+    };
+    /** SiFive-hifive1-revb PWM parameters
+        See
+        freedom-e-sdk/bsp/sifive-hifive1-revb/core.dts
+        pwm@10025000 and pwm@10035000: sifive,comparator-widthbits = <16>
+     */
+    using default_pwm_config = pwm_config<>;
+    /** SiFive-hifive1-revb PWM0 parameters, pwm@10015000: sifive,comparator-widthbits = <8>
+     */
+    using pwm0_config = pwm_config<default_clock_config, 8>;
+
+    /** Counter scale and period compare value for a PWM period */
+    struct pwm_timing {
+        std::uint8_t scale;
+        // Number of scaled counter ticks per period, pwmcmp0 + 1
+        std::uint32_t period;
+    };
+
+    /** PWM driver. The counter runs continuously and resets on comparator 0.
+        Output N (1 to 3) is high for the duty time at the end of each period.
+        Active low loads, such as the HiFive1 LEDs, can be inverted with the GPIO out_xor register.
+        @tparam BASE_ADDR Base address of the PWM device.
+        @tparam CONFIG    Clock and comparator width.
+        Template ACCESS is the MMIO access policy, e.g. mmio_device::direct_access, or mmio_sim::sim_access on a host.
+     */
+    template<std::uintptr_t BASE_ADDR,
+             class CONFIG=default_pwm_config,
+             template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class pwm {
+    public:
+        /** Duration of each unscaled counter tick */
+        using pwm_ticks = std::chrono::duration<std::uint64_t, std::ratio<1, CONFIG::CORE_CLOCK_HZ>>;
+        /** Largest comparator value */
+        static constexpr std::uint32_t CMP_MAX = (1UL << CONFIG::CMP_WIDTH) - 1;
+        /** Largest counter scale */
+        static constexpr unsigned int SCALE_MAX = 15;
+
+        /** Find the smallest counter scale, the best duty resolution, for a period.
+            The period is at most CMP_MAX scaled ticks, so that a duty of 0 fits in a comparator.
+         */
+        template<class D> static constexpr pwm_timing timing(D period) {
+            const std::uint64_t ticks = std::chrono::duration_cast<pwm_ticks>(period).count();
+            unsigned int scale = 0;
+            while ((scale < SCALE_MAX) && ((ticks >> scale) > CMP_MAX)) {
+                scale++;
+            }
+            const std::uint64_t scaled = ticks >> scale;
+            return pwm_timing{static_cast<std::uint8_t>(scale),
+                              static_cast<std::uint32_t>((scaled > CMP_MAX) ? CMP_MAX : ((scaled < 1) ? 1 : scaled))};
+        }
+        /** Comparator value for an output high time within a period.
+            The output is high while the scaled count is >= the comparator value.
+         */
+        template<class D> static constexpr std::uint32_t compare(pwm_timing period, D duty) {
+            const std::uint64_t ticks = std::chrono::duration_cast<pwm_ticks>(duty).count() >> period.scale;
+            return (ticks >= period.period) ? 0 : static_cast<std::uint32_t>(period.period - ticks);
+        }
+
+        /** Start the PWM counter with all outputs low. */
+        explicit pwm(pwm_timing period) {
+            _dev.pwmcount.write(0);
+            set_compare<1>(period.period);
+            set_compare<2>(period.period);
+            set_compare<3>(period.period);
+            set_period(period);
+        }
+        template<class D> explicit pwm(D period)
+            : pwm(timing(period)) {}
+        // Boilerplate delete defaults - non copyable class
+        pwm(const pwm&) = delete;
+        pwm &operator=(const pwm&) = delete;
+        pwm(pwm&&) = delete;
+        pwm &operator=(pwm&&) = delete;
+
+        /** Set the period of all outputs. The duties are not rescaled. */
+        void set_period(pwm_timing period) {
+            _timing = period;
+            _dev.template pwmcmp<0>.write(period.period - 1);
+            _dev.pwmcfg.modify(_dev.pwmcfg.pwmscale.value(period.scale),
+                               _dev.pwmcfg.pwmsticky.value(false),
+                               _dev.pwmcfg.pwmzerocmp.value(true),
+                               _dev.pwmcfg.pwmdeglitch.value(true),
+                               _dev.pwmcfg.pwmenalways.value(true),
+                               _dev.pwmcfg.pwmenoneshot.value(false));
+        }
+        template<class D> void set_period(D period) {
+            set_period(timing(period));
+        }
+
+        /** Set the high time of an output. */
+        template<unsigned int OUTPUT, class D> void set_duty(D duty) {
+            set_compare<OUTPUT>(compare(_timing, duty));
+        }
+        /** Set the high time of an output as a fraction of the period, e.g. for LED dimming. */
+        template<unsigned int OUTPUT> void set_duty_fraction(std::uint32_t numerator, std::uint32_t denominator) {
+            const std::uint32_t high = static_cast<std::uint32_t>((static_cast<std::uint64_t>(_timing.period) * numerator) / denominator);
+            set_compare<OUTPUT>((high >= _timing.period) ? 0 : (_timing.period - high));
+        }
+        /** Set the raw comparator value of an output. */
+        template<unsigned int OUTPUT> void set_compare(std::uint32_t value) {
+            static_assert((OUTPUT > 0) && (OUTPUT < 4), "Comparator 0 sets the period, outputs are 1 to 3");
+            _dev.template pwmcmp<OUTPUT>.write(value);
+        }
+
+        /** The current period setting */
+        pwm_timing period(void) const {
+            return _timing;
+        }
+
+    private:
+        sifive_pwm0_0_dev<BASE_ADDR, ACCESS> _dev;
+        pwm_timing _timing;
+    };
+}
+
+#endif // #ifndef PWM_HPP
@@ -0,0 +1,169 @@
+/*
+   Execute in place (XIP) setup of the QSPI flash controller.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   At reset the flash controller fetches instructions with the single bit
+   read command (0x03) and a slow serial clock. This switches the memory
+   mapped reads to the quad I/O fast read command (0xEB), with the address,
+   dummy cycles and data on four lines, and sets the serial clock divider.
+
+   - The flash quad enable (QE) status bit is set with programmed I/O, only
+     if it is not already set, as the status register is non-volatile.
+   - The flash can not be read while the controller is in programmed I/O
+     mode, so enable() is always inlined, into a non-template function placed
+     in the .itim section and called after the ITIM is initialized (see
+     startup.cpp, and the .itim rule in linker.lds).
+   - The divider is set for CONFIG::MAX_CORE_CLOCK_HZ, so the flash clock
+     stays in range when driver::prci raises the core clock later.
+
+   e.g.
+       extern "C" __attribute__((noinline, flatten, section(".itim.qspi_xip_enable"))) void qspi_xip_enable(void) {
+           driver::qspi_xip<QSPI0_ADDR> xip;
+           xip.enable();
+       }
+
+*/
+
+#ifndef QSPI_XIP_HPP
+#define QSPI_XIP_HPP
+
+#include <cstdint>
+
+// MMIO register access policies
+#include "mmio_device.hpp"
+
+// Clock tree configuration
+#include "clock_config.hpp"
+
+// MMIO Device interface definition, generated by tools/svd2mmio.py
+#include "device/sifive_spi0_0_mmio_dev.hpp"
+
+namespace driver {
+
+    /** QSPI flash parameters.
+        The flash controller is clocked by tlclk, the core clock.
+        @tparam CLOCK Clock configuration, the divider is set for CLOCK::MAX_CORE_CLOCK_HZ.
+     */
+    template<class CLOCK=default_clock_config> struct qspi_xip_config : CLOCK {
+        // See
+        // freedom-e-sdk/bsp/sifive-hifive1-revb/core.dts
+        // flash@20000000: issi,is25lp032
+        static constexpr std::uint32_t FLASH_MAX_SCK_HZ=50000000;
+        // Fast read quad I/O, 24 bit address
+        static constexpr std::uint8_t READ_CMD=0xEB;
+        // Mode bits and dummy clocks after the address, the IS25LP default for 0xEB
+        static constexpr unsigned int DUMMY_CYCLES=6;
+        // Status register quad enable bit
+        static constexpr std::uint8_t STATUS_QE=0x40;
+    };
+    /** SiFive-hifive1-revb QSPI flash parameters
+     */
+    using default_qspi_xip_config = qspi_xip_config<>;
+
+    /** QSPI flash execute in place driver.
+        @tparam BASE_ADDR Base address of the QSPI controller, the flash is memory mapped.
+        @tparam CONFIG    Clock and flash read command.
+        Template ACCESS is the MMIO access policy, e.g. mmio_device::direct_access, or mmio_sim::sim_access on a host.
+     */
+    template<std::uintptr_t BASE_ADDR,
+             class CONFIG=default_qspi_xip_config,
+             template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class qspi_xip {
+        using txdata_r = mmio_param::sifive_spi0_0::txdata_r;
+        using rxdata_r = mmio_param::sifive_spi0_0::rxdata_r;
+    public:
+        /** Serial clock divider, f_sck = f_core / (2*(SCK_DIV+1)) */
+        static constexpr std::uint32_t SCK_DIV =
+            (CONFIG::MAX_CORE_CLOCK_HZ + 2*CONFIG::FLASH_MAX_SCK_HZ - 1) / (2*CONFIG::FLASH_MAX_SCK_HZ) - 1;
+        static_assert(SCK_DIV < 4096, "The flash clock divider is out of range");
+        static_assert(CONFIG::DUMMY_CYCLES < 16, "The controller supports up to 15 dummy cycles");
+
+        /** Flash commands */
+        static constexpr std::uint8_t CMD_WRITE_ENABLE = 0x06;
+        static constexpr std::uint8_t CMD_READ_STATUS = 0x05;
+        static constexpr std::uint8_t CMD_WRITE_STATUS = 0x01;
+        /** Status register write in progress bit */
+        static constexpr std::uint8_t STATUS_WIP = 0x01;
+
+        qspi_xip(void) {}
+        // Boilerplate delete defaults - non copyable class
+        qspi_xip(const qspi_xip&) = delete;
+        qspi_xip &operator=(const qspi_xip&) = delete;
+        qspi_xip(qspi_xip&&) = delete;
+        qspi_xip &operator=(qspi_xip&&) = delete;
+
+        /** Switch the memory mapped flash reads to quad I/O.
+            Must be inlined into a function in the ITIM, the flash is not readable until it returns.
+            Interrupts must be disabled, handlers in flash can not be fetched.
+         */
+        inline void enable(void) __attribute__((always_inline)) {
+            // Programmed I/O: 8 bit single line frames, receive enabled.
+            _dev.fctrl.en.clear();
+            _dev.fmt.modify(_dev.fmt.proto.value(0),
+                            _dev.fmt.endian.value(false),
+                            _dev.fmt.dir.value(false),
+                            _dev.fmt.len.value(8));
+            while (!(_dev.rxdata.read() & rxdata_r::empty_f::bit_mask)) {
+            }
+            const std::uint8_t status = read_status();
+            if (!(status & CONFIG::STATUS_QE)) {
+                command(CMD_WRITE_ENABLE);
+                _dev.csmode.mode.write(CS_HOLD);
+                transfer(CMD_WRITE_STATUS);
+                transfer(status | CONFIG::STATUS_QE);
+                _dev.csmode.mode.write(CS_AUTO);
+                // Wait for the non-volatile write.
+                while (read_status() & STATUS_WIP) {
+                }
+            }
+            _dev.sckdiv.write(SCK_DIV);
+            // Command on one line, address, mode bits and data on four lines.
+            _dev.ffmt.modify(_dev.ffmt.cmd_en.value(true),
+                             _dev.ffmt.addr_len.value(3),
+                             _dev.ffmt.pad_cnt.value(CONFIG::DUMMY_CYCLES),
+                             _dev.ffmt.cmd_proto.value(PROTO_SINGLE),
+                             _dev.ffmt.addr_proto.value(PROTO_QUAD),
+                             _dev.ffmt.data_proto.value(PROTO_QUAD),
+                             _dev.ffmt.cmd_code.value(CONFIG::READ_CMD),
+                             // Mode bits 0x00, continuous read is not enabled.
+                             _dev.ffmt.pad_code.value(0));
+            _dev.fctrl.en.set();
+        }
+
+    private:
+        static constexpr std::uint8_t PROTO_SINGLE = 0;
+        static constexpr std::uint8_t PROTO_QUAD = 2;
+        static constexpr std::uint8_t CS_AUTO = 0;
+        static constexpr std::uint8_t CS_HOLD = 2;
+
+        sifive_spi0_0_dev<BASE_ADDR, ACCESS> _dev;
+
+        /** Send and receive one byte. */
+        inline std::uint8_t transfer(std::uint8_t value) __attribute__((always_inline)) {
+            while (_dev.txdata.read() & txdata_r::full_f::bit_mask) {
+            }
+            _dev.txdata.write(value);
+            std::uint32_t rx;
+            do {
+                rx = _dev.rxdata.read();
+            } while (rx & rxdata_r::empty_f::bit_mask);
+            return static_cast<std::uint8_t>(rx & rxdata_r::data_f::bit_mask);
+        }
+        /** A single byte command, chip select is released after the command. */
+        inline void command(std::uint8_t cmd) __attribute__((always_inline)) {
+            _dev.csmode.mode.write(CS_HOLD);
+            transfer(cmd);
+            _dev.csmode.mode.write(CS_AUTO);
+        }
+        inline std::uint8_t read_status(void) __attribute__((always_inline)) {
+            _dev.csmode.mode.write(CS_HOLD);
+            transfer(CMD_READ_STATUS);
+            const std::uint8_t status = transfer(0);
+            _dev.csmode.mode.write(CS_AUTO);
+            return status;
+        }
+    };
+}
+
+#endif // #ifndef QSPI_XIP_HPP
@@ -0,0 +1,119 @@
+/*
+   Lock-free single producer, single consumer ring buffer.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Data streams between an interrupt handler and the main loop, e.g. UART
+   receive and transmit buffers. One side only writes the head index and
+   the other side only writes the tail index, so no critical section or
+   compare and swap is needed.
+
+*/
+
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Compile time checks
+#include "util.hpp"
+
+namespace irq {
+
+    /** Lock-free ring buffer with one producer and one consumer.
+        e.g. The producer is the UART receive interrupt handler, the consumer is the main loop.
+        @tparam SIZE Number of elements. Must be a power of two.
+        @tparam T    Element type, copied by value.
+     */
+    template<std::size_t SIZE, class T=std::uint8_t> class ring_buffer {
+    public:
+        static_assert(util::is_power_of_two(SIZE), "The ring buffer size must be a power of two");
+        static_assert(std::is_trivially_copyable_v<T>, "Ring buffer elements are copied by value");
+
+        ring_buffer(void) {}
+        // Boilerplate delete defaults - non copyable class
+        ring_buffer(const ring_buffer&) = delete;
+        ring_buffer &operator=(const ring_buffer&) = delete;
+        ring_buffer(ring_buffer&&) = delete;
+        ring_buffer &operator=(ring_buffer&&) = delete;
+
+        /** Producer: Add an element.
+            @retval false The buffer is full.
+         */
+        bool push(T const &value) {
+            const std::uint32_t head = _head.load(std::memory_order_relaxed);
+            if ((head - _tail.load(std::memory_order_acquire)) >= SIZE) {
+                return false;
+            }
+            _data[head & (SIZE-1)] = value;
+            // Publish the element to the consumer.
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+        /** Producer: Add up to length elements, the index is published once.
+            @retval The number of elements added.
+         */
+        std::size_t push(T const *values, std::size_t length) {
+            const std::uint32_t head = _head.load(std::memory_order_relaxed);
+            const std::size_t space = SIZE - (head - _tail.load(std::memory_order_acquire));
+            const std::size_t count = (length < space) ? length : space;
+            for (std::size_t i = 0; i < count; i++) {
+                _data[(head + i) & (SIZE-1)] = values[i];
+            }
+            _head.store(head + static_cast<std::uint32_t>(count), std::memory_order_release);
+            return count;
+        }
+
+        /** Consumer: Remove an element.
+            @retval false The buffer is empty.
+         */
+        bool pop(T &value) {
+            const std::uint32_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _head.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = _data[tail & (SIZE-1)];
+            // Release the slot to the producer.
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+        /** Consumer: Remove up to length elements, the index is published once.
+            @retval The number of elements removed.
+         */
+        std::size_t pop(T *values, std::size_t length) {
+            const std::uint32_t tail = _tail.load(std::memory_order_relaxed);
+            const std::size_t available = _head.load(std::memory_order_acquire) - tail;
+            const std::size_t count = (length < available) ? length : available;
+            for (std::size_t i = 0; i < count; i++) {
+                values[i] = _data[(tail + i) & (SIZE-1)];
+            }
+            _tail.store(tail + static_cast<std::uint32_t>(count), std::memory_order_release);
+            return count;
+        }
+
+        /** Number of elements in the buffer. */
+        std::size_t size(void) const {
+            return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+        }
+        /** Check if there are no elements in the buffer. */
+        bool empty(void) const {
+            return size() == 0;
+        }
+        /** Number of elements that can be added. */
+        std::size_t space(void) const {
+            return SIZE - size();
+        }
+
+    private:
+        T _data[SIZE];
+        // Free running indexes, the element is the index modulo SIZE.
+        std::atomic<std::uint32_t> _head{0};
+        std::atomic<std::uint32_t> _tail{0};
+    };
+}
+
+#endif // #ifndef RING_BUFFER_HPP
@@ -24,6 +24,20 @@ namespace riscv {
         static constexpr std::uint32_t uei = 8;
     };/*interrupts*/
     struct exceptions {
+        static constexpr std::uint32_t instruction_address_misaligned = 0;
+        static constexpr std::uint32_t instruction_access_fault = 1;
+        static constexpr std::uint32_t illegal_instruction = 2;
+        static constexpr std::uint32_t breakpoint = 3;
+        static constexpr std::uint32_t load_address_misaligned = 4;
+        static constexpr std::uint32_t load_access_fault = 5;
+        static constexpr std::uint32_t store_amo_address_misaligned = 6;
+        static constexpr std::uint32_t store_amo_access_fault = 7;
+        static constexpr std::uint32_t ecall_u = 8;
+        static constexpr std::uint32_t ecall_s = 9;
+        static constexpr std::uint32_t ecall_m = 11;
+        static constexpr std::uint32_t instruction_page_fault = 12;
+        static constexpr std::uint32_t load_page_fault = 13;
+        static constexpr std::uint32_t store_amo_page_fault = 15;
     };/*exceptions*/
 } /* riscv */
 
@@ -12,16 +12,20 @@
 #include <cstdint>
 #include <chrono>
 
+// Register width on host builds
+#include "platform.hpp"
+
+// MMIO register access policies
+#include "mmio_device.hpp"
+
+// Clock tree configuration
+#include "clock_config.hpp"
+
 namespace driver {
 
-    /** SiFive-hifive1-revb TIMER device parameters
+    /** SiFive-hifive1-revb TIMER device parameters, MTIME_FREQ_HZ from the clock configuration.
      */
-    struct default_timer_config {
-        // See
-        // freedom-e-sdk/bsp/sifive-hifive1-revb/core.dts
-        // psdlfaltclk: clock@6
-        // Fixed to 32Khz
-        static constexpr unsigned int MTIME_FREQ_HZ=32768;
+    struct default_timer_config : default_clock_config {
     };
 
     /** Default definintion of a the memory mapped mtimer CSR registers.
@@ -35,14 +39,58 @@ namespace driver {
     };
 
     /** Simple TIMER driver class 
+        Template ACCESS is the MMIO access policy, e.g. mmio_device::direct_access, or mmio_sim::sim_access on a host.
      */
     template<class ADDRESS_SPEC=mtimer_address_spec, 
-             class CONFIG=default_timer_config> class timer {
+             class CONFIG=default_timer_config,
+             template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class timer {
+        using mtime_t = ACCESS<ADDRESS_SPEC::MTIME_ADDR, std::uint64_t>;
+        using mtimel_t = ACCESS<ADDRESS_SPEC::MTIME_ADDR, std::uint32_t>;
+        using mtimeh_t = ACCESS<ADDRESS_SPEC::MTIME_ADDR+4, std::uint32_t>;
+        using mtimecmp_t = ACCESS<ADDRESS_SPEC::MTIMECMP_ADDR, std::uint64_t>;
+        using mtimecmpl_t = ACCESS<ADDRESS_SPEC::MTIMECMP_ADDR, std::uint32_t>;
+        using mtimecmph_t = ACCESS<ADDRESS_SPEC::MTIMECMP_ADDR+4, std::uint32_t>;
     public :
 
         /** Duration of each timer tick */
         using timer_ticks = std::chrono::duration<int, std::ratio<1, CONFIG::MTIME_FREQ_HZ>>;
 
+        /** std::chrono clock of the mtime counter.
+            Meets the requirements of a C++ Clock. The epoch is the initialization of the mtime counter.
+         */
+        struct clock {
+            using rep = std::int64_t;
+            using period = std::ratio<1, CONFIG::MTIME_FREQ_HZ>;
+            using duration = std::chrono::duration<rep, period>;
+            using time_point = std::chrono::time_point<clock>;
+            static constexpr bool is_steady = true;
+            static time_point now(void) noexcept {
+                return time_point(duration(timer().get_raw_time()));
+            }
+        };
+        using time_point = typename clock::time_point;
+
+        /** Set the timer compare point to an absolute std::chrono::time_point deadline
+         */
+        template<class D> void set_time_cmp_at(std::chrono::time_point<clock, D> deadline) {
+            set_raw_time_cmp_at(std::chrono::time_point_cast<typename clock::duration>(deadline).time_since_epoch().count());
+        }
+        /** Advance a periodic deadline by one period, and set the timer compare point to the new deadline.
+            The period is relative to the previous deadline rather than the current time, so interrupt latency
+            does not accumulate as drift. If the new deadline has already passed, whole periods are skipped to
+            keep the phase of the period.
+            @param deadline The previous deadline, updated to the new deadline.
+         */
+        template<class T=std::chrono::microseconds> void set_time_cmp_periodic(time_point &deadline, T period) {
+            const auto period_ticks = std::chrono::duration_cast<typename clock::duration>(period);
+            deadline += period_ticks;
+            const auto now = clock::now();
+            if (deadline <= now) {
+                deadline += ((now - deadline) / period_ticks + 1) * period_ticks;
+            }
+            set_time_cmp_at(deadline);
+        }
+
 
         /** Set the timer compare point using a std::chrono::duration timer offset 
          */
@@ -73,20 +121,37 @@ namespace driver {
         void set_raw_time_cmp(uint64_t clock_offset) {
             // First of all set 
             auto new_mtimecmp = get_raw_time() + clock_offset;
+            set_raw_time_cmp_at(new_mtimecmp);
+        }
+
+        /** Set the raw time compare point as an absolute mtime value in system timer clocks.
+         * An interrupt will be generated when mtime >= new_mtimecmp.
+         */
+        void set_raw_time_cmp_at(uint64_t new_mtimecmp) {
             if constexpr ( __riscv_xlen == 64) {
                 // Single bus access
-                auto mtimecmp = reinterpret_cast<volatile std::uint64_t *>(ADDRESS_SPEC::MTIMECMP_ADDR);
-                *mtimecmp = new_mtimecmp;
+                mtimecmp_t::write(new_mtimecmp);
             } else {
-                auto mtimecmpl = reinterpret_cast<volatile std::uint32_t *>(ADDRESS_SPEC::MTIMECMP_ADDR);
-                auto mtimecmph = reinterpret_cast<volatile std::uint32_t *>(ADDRESS_SPEC::MTIMECMP_ADDR+4);
                 // AS we are doing 32 bit writes, an intermediate mtimecmp value may cause spurious interrupts.
                 // Prevent that by first setting the dummy MSB to an unacheivable value
-                *mtimecmph = 0xFFFFFFFF;  // cppcheck-suppress redundantAssignment
+                mtimecmph_t::write(0xFFFFFFFF);
                 // set the LSB
-                *mtimecmpl = static_cast<uint32_t>(new_mtimecmp & 0x0FFFFFFFFUL);
+                mtimecmpl_t::write(static_cast<uint32_t>(new_mtimecmp & 0x0FFFFFFFFUL));
                 // Set the correct MSB
-                *mtimecmph = static_cast<uint32_t>(new_mtimecmp >> 32); // cppcheck-suppress redundantAssignment
+                mtimecmph_t::write(static_cast<uint32_t>(new_mtimecmp >> 32));
+            }
+        }
+
+        /** Read the raw time compare point in system timer clocks.
+         * This is the absolute mtime value of the next timer interrupt.
+         */
+        uint64_t get_raw_time_cmp(void) {
+            if constexpr ( __riscv_xlen == 64) {
+                // Directly read 64 bit value
+                return mtimecmp_t::read();
+            } else {
+                // Only written by software, so no need to check for a tick over between the reads.
+                return (static_cast<std::uint64_t>(mtimecmph_t::read())<<32)|mtimecmpl_t::read();
             }
         }
 
@@ -95,23 +160,78 @@ namespace driver {
         uint64_t get_raw_time(void) {
             if constexpr ( __riscv_xlen == 64) {
                 // Directly read 64 bit value
-                auto mtime = reinterpret_cast<volatile std::uint64_t *>(ADDRESS_SPEC::MTIME_ADDR);
-                return *mtime;
+                return mtime_t::read();
             } else {
-                auto mtimel = reinterpret_cast<volatile std::uint32_t *>(ADDRESS_SPEC::MTIME_ADDR);
-                auto mtimeh = reinterpret_cast<volatile std::uint32_t *>(ADDRESS_SPEC::MTIME_ADDR+4);
                 uint32_t mtimeh_val;
                 uint32_t mtimel_val;
                 do {
                     // There is a small risk the mtimeh will tick over after reading mtimel
-                    mtimeh_val = *mtimeh;
-                    mtimel_val = *mtimel;
+                    mtimeh_val = mtimeh_t::read();
+                    mtimel_val = mtimel_t::read();
                     // Poll mtimeh to ensure it's consistent after reading mtimel
                     // The frequency of mtimeh ticking over is low
-                } while (mtimeh_val != *mtimeh);
+                } while (mtimeh_val != mtimeh_t::read());
                 return (static_cast<std::uint64_t>(mtimeh_val)<<32)|mtimel_val;
             } 
         }
+
+        /** Read the low 32 bits of the system timer in system timer clocks.
+         * This is a single bus access, mtimeh is not read.
+         * For interval measurements shorter than 2^32 clocks the unsigned difference of two short
+         * timestamps is correct across a wrap of the low word.
+         */
+        uint32_t get_raw_time_short(void) {
+            return mtimel_t::read();
+        }
+    };
+
+    /** Timestamp source caching the high word of mtime.
+     * On RV32 a consistent 64 bit mtime read is at least three bus accesses (mtimeh, mtimel, mtimeh).
+     * This reads mtimel only, and re-reads mtimeh only when mtimel is seen to wrap.
+     * @note The cache is not shared, use one instance for each context (idle loop, each interrupt level).
+     * @note now() must be called at least once per wrap of mtimel (2^32 clocks, ~36 hours at 32768Hz),
+     *       otherwise call sync() to re-read mtimeh.
+     */
+    template<class TIMER=timer<>> class timestamp_source {
+    public :
+        explicit timestamp_source(TIMER &timer)
+            : _timer(timer) {
+            sync();
+        }
+        // Boilerplate delete defaults - non copyable class
+        timestamp_source(const timestamp_source&) = delete;
+        timestamp_source &operator=(const timestamp_source&) = delete;
+        timestamp_source(timestamp_source&&) = delete;
+        timestamp_source &operator=(timestamp_source&&) = delete;
+
+        /** Read the raw time of the system timer in system timer clocks, using the cached high word.
+         */
+        uint64_t now(void) {
+            if constexpr ( __riscv_xlen == 64) {
+                // Already a single bus access
+                return _timer.get_raw_time();
+            } else {
+                const uint32_t low = _timer.get_raw_time_short();
+                if (low < _low) {
+                    // mtimel has wrapped, re-read mtimeh
+                    return sync();
+                }
+                _low = low;
+                return (static_cast<std::uint64_t>(_high)<<32)|low;
+            }
+        }
+        /** Re-read the full system timer and update the cached high word.
+         */
+        uint64_t sync(void) {
+            const uint64_t time = _timer.get_raw_time();
+            _high = static_cast<uint32_t>(time >> 32);
+            _low = static_cast<uint32_t>(time);
+            return time;
+        }
+    private:
+        TIMER &_timer;
+        uint32_t _high = 0;
+        uint32_t _low = 0;
     };
 }
 
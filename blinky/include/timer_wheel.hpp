@@ -0,0 +1,397 @@
+/*
+   Hierarchical timer wheel for the RISC-V machine mode timer.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Multiplexes many one-shot and periodic software timers onto the single
+   mtimecmp comparator of driver::timer.
+
+   e.g.
+       driver::timer_wheel<decltype(mtimer)> wheel(mtimer);
+       static const auto blink = [&] (void) { gpio_dev.output_val ^= LED_MASK_WHITE; };
+       static driver::timer_node blink_timer(blink);
+       wheel.start_periodic(blink_timer, std::chrono::milliseconds{500});
+       // In the mti interrupt handler
+       wheel.process();
+       // In the idle loop
+       wheel.idle([] { return false; });
+
+*/
+
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstdint>
+#include <chrono>
+
+// Critical sections
+#include "critical_section.hpp"
+
+namespace driver {
+
+    template<class TIMER, unsigned int LEVELS, unsigned int SLOT_BITS> class timer_wheel;
+
+    /** A software timer. Intrusive node of the timer wheel, no dynamic memory allocation is used.
+        The callback function object is called from the timer interrupt handler when the timer expires.
+     */
+    class timer_node {
+    public:
+        /** Create a timer to call a function object on expiry.
+            This is defined as a template to prevent dynamic memory allocation. */
+        template<class T> timer_node(T const &callback)
+            : _execute([](const void *context)
+                {
+                    // Call into the function object.
+                    static_cast<T const *>(context)->operator()();
+                })
+            , _context(&callback) {}
+        // Boilerplate delete defaults - non copyable class, the wheel holds pointers to the node.
+        timer_node(const timer_node&) = delete;
+        timer_node &operator=(const timer_node&) = delete;
+        timer_node(timer_node&&) = delete;
+        timer_node &operator=(timer_node&&) = delete;
+
+        /** Check if the timer is started. */
+        bool active(void) const {
+            return _active;
+        }
+    private:
+        template<class TIMER, unsigned int LEVELS, unsigned int SLOT_BITS> friend class timer_wheel;
+
+        void (* const _execute)(const void *context);
+        const void * const _context;
+        // Intrusive slot list
+        timer_node *_next = nullptr;
+        timer_node *_prev = nullptr;
+        // Absolute expiry time in raw timer ticks
+        std::uint64_t _expiry = 0;
+        // Period in raw timer ticks, 0 for a one-shot timer
+        std::uint64_t _period = 0;
+        std::uint8_t _level = 0;
+        std::uint8_t _slot = 0;
+        bool _active = false;
+    };
+
+    /** Hierarchical timer wheel.
+
+        Level L has 2^SLOT_BITS slots, each slot covers 2^(SLOT_BITS*L) timer ticks.
+        Timers are inserted into the lowest level that can hold them, and moved (cascaded)
+        to lower levels as time advances. Timers beyond the range of the top level are held in
+        the last slot of the top level and cascaded until they are in range.
+
+        - Start and cancel are O(1).
+        - Finding the next event is O(LEVELS), using an occupancy bitmap per level.
+        - The comparator is only programmed with the earliest timer deadline (tickless),
+          higher levels are cascaded when the wheel is processed at that deadline.
+
+        @tparam TIMER     driver::timer type providing the mtime/mtimecmp access.
+        @tparam LEVELS    Number of levels.
+        @tparam SLOT_BITS log2 of the number of slots per level.
+     */
+    template<class TIMER, unsigned int LEVELS=4, unsigned int SLOT_BITS=5> class timer_wheel {
+    public:
+        static_assert(SLOT_BITS <= 5, "The slot occupancy bitmap is 32 bits");
+        static_assert(LEVELS * SLOT_BITS < 64, "The timer wheel range exceeds the timer counter");
+
+        static constexpr unsigned int SLOTS = 1U << SLOT_BITS;
+        static constexpr std::uint64_t SLOT_MASK = SLOTS - 1;
+        /** Raw comparator value that will never generate an interrupt */
+        static constexpr std::uint64_t NEVER = UINT64_MAX;
+
+        using timer_ticks = typename TIMER::timer_ticks;
+
+        explicit timer_wheel(TIMER &timer)
+            : _timer(timer)
+            , _now(timer.get_raw_time()) {}
+        // Boilerplate delete defaults - non copyable class
+        timer_wheel(const timer_wheel&) = delete;
+        timer_wheel &operator=(const timer_wheel&) = delete;
+        timer_wheel(timer_wheel&&) = delete;
+        timer_wheel &operator=(timer_wheel&&) = delete;
+
+        /** Start a one-shot timer, expiring after a std::chrono::duration timer offset */
+        template<class T=std::chrono::microseconds> void start_oneshot(timer_node &node, T time_offset) {
+            start_raw(node, std::chrono::duration_cast<timer_ticks>(time_offset).count(), 0);
+        }
+        /** Start a periodic timer.
+            The next expiry is advanced from the previous expiry, so the period does not drift with interrupt latency.
+         */
+        template<class T=std::chrono::microseconds> void start_periodic(timer_node &node, T period) {
+            auto period_ticks = std::chrono::duration_cast<timer_ticks>(period).count();
+            start_raw(node, period_ticks, period_ticks);
+        }
+        /** Start a timer in raw timer ticks.
+            @param clock_offset Expiry relative to the current time.
+            @param period       Period of a periodic timer, or 0 for a one-shot timer.
+                                A period shorter than one timer tick is a one-shot timer.
+         */
+        void start_raw(timer_node &node, std::uint64_t clock_offset, std::uint64_t period) {
+            irq::critical_section lock;
+            if (node._active) {
+                remove(node);
+            }
+            auto now = _timer.get_raw_time();
+            if (_active_count == 0) {
+                // Resynchronize the idle wheel to the current time.
+                _now = now;
+            }
+            node._expiry = now + clock_offset;
+            if (node._expiry <= _now) {
+                // Restarted from an expiry callback, e.g. start_raw(node, 0, 0). The current slot is
+                // being expired, wait for the next tick so the callback can not loop within process().
+                node._expiry = _now + 1;
+            }
+            node._period = period;
+            insert(node);
+            reprogram();
+        }
+        /** Stop a timer. */
+        void cancel(timer_node &node) {
+            irq::critical_section lock;
+            if (node._active) {
+                remove(node);
+                reprogram();
+            }
+        }
+
+        /** Process the wheel. Call from the machine timer interrupt handler.
+            Expired timers are called, higher levels are cascaded, and the comparator is reprogrammed.
+         */
+        void process(void) {
+            irq::critical_section lock;
+            const std::uint64_t target = _timer.get_raw_time();
+            while (true) {
+                expire();
+                std::uint64_t next = NEVER;
+                if (!next_event(next) || (next > target)) {
+                    // No events between now and the current time.
+                    if (target > _now) {
+                        _now = target;
+                    }
+                    break;
+                }
+                _now = next;
+                cascade();
+            }
+            reprogram();
+        }
+
+        /** Find the time of the next event in raw timer ticks.
+            This includes the cascade of higher levels, the wheel must be processed at each event.
+            @retval false No timers are active.
+         */
+        bool next_event(std::uint64_t &next) const {
+            bool found = false;
+            for (unsigned int level = 0; level < LEVELS; level++) {
+                unsigned int distance;
+                if (!next_slot(level, distance)) {
+                    continue;
+                }
+                const unsigned int shift = SLOT_BITS * level;
+                const std::uint64_t slot_time = ((_now >> shift) + distance) << shift;
+                const std::uint64_t event = (slot_time < _now) ? _now : slot_time;
+                if (!found || (event < next)) {
+                    next = event;
+                    found = true;
+                }
+            }
+            return found;
+        }
+
+        /** Find the earliest timer deadline in raw timer ticks.
+            Unlike next_event() the cascade events of higher levels are not included,
+            the earliest expiry of the timers held in higher levels is used instead.
+            This is the only time the comparator needs to be programmed for.
+            @retval false No timers are active.
+         */
+        bool next_deadline(std::uint64_t &next) const {
+            bool found = false;
+            for (unsigned int level = 0; level < LEVELS; level++) {
+                unsigned int distance;
+                if (!next_slot(level, distance)) {
+                    continue;
+                }
+                const unsigned int shift = SLOT_BITS * level;
+                const unsigned int slot = ((_now >> shift) + distance) & SLOT_MASK;
+                // Level 0 slots hold a single tick, higher levels are searched for the earliest expiry.
+                std::uint64_t event = (level == 0) ? (_now + distance) : NEVER;
+                if (level != 0) {
+                    for (const timer_node *node = _slots[level][slot]; node; node = node->_next) {
+                        if (node->_expiry < event) {
+                            event = node->_expiry;
+                        }
+                    }
+                }
+                if (event < _now) {
+                    event = _now;
+                }
+                if (!found || (event < next)) {
+                    next = event;
+                    found = true;
+                }
+            }
+            return found;
+        }
+
+        /** Tickless idle. Sleep with wfi until the next timer deadline or another interrupt.
+            The comparator is only programmed for the next pending deadline, there is no periodic tick
+            and no wakeup for the cascade of higher levels. If no timers are active the core sleeps until another interrupt.
+            @param work_pending Function object called with interrupts disabled. Returns true if there is work
+                                pending and the core must not sleep, e.g. a work queue is not empty.
+         */
+        template<class T> void idle(T const &work_pending) {
+            // Interrupts are disabled so work queued by an interrupt can not be missed before entering wfi.
+            // A pending interrupt will still wake the core, and is taken at the end of the critical section.
+            irq::critical_section lock;
+            if (!work_pending()) {
+                __asm__ volatile ("wfi");
+            }
+        }
+
+        /** Check if any timers are active. */
+        bool empty(void) const {
+            return _active_count == 0;
+        }
+
+    private:
+        TIMER &_timer;
+        // Current time of the wheel in raw timer ticks
+        std::uint64_t _now;
+        unsigned int _active_count = 0;
+        timer_node *_slots[LEVELS][SLOTS] = {};
+        std::uint32_t _occupied[LEVELS] = {};
+
+        /** Find the next occupied slot of a level.
+            @param distance Number of slots after the current slot.
+            @retval false There are no timers at this level.
+         */
+        bool next_slot(unsigned int level, unsigned int &distance) const {
+            if (_occupied[level] == 0) {
+                return false;
+            }
+            const unsigned int current = (_now >> (SLOT_BITS * level)) & SLOT_MASK;
+            // Level 0 may hold expired timers in the current slot, higher levels always hold future slots.
+            const unsigned int first = (level == 0) ? 0 : 1;
+            // Rotate the bitmap so bit 0 is the current slot.
+            const std::uint32_t rotated = rotate_right(_occupied[level], current);
+            const std::uint32_t future = rotated & ~((1UL << first) - 1);
+            if (future == 0) {
+                return false;
+            }
+            distance = __builtin_ctz(future);
+            return true;
+        }
+
+        static std::uint32_t rotate_right(std::uint32_t value, unsigned int bits) {
+            if constexpr (SLOTS == 32) {
+                return (bits == 0) ? value : ((value >> bits) | (value << (32 - bits)));
+            } else {
+                constexpr std::uint32_t mask = (1UL << SLOTS) - 1;
+                return ((value >> bits) | (value << (SLOTS - bits))) & mask;
+            }
+        }
+
+        void insert(timer_node &node) {
+            unsigned int level = 0;
+            std::uint64_t slot_index = 0;
+            if (node._expiry <= _now) {
+                // Already expired, add to the current level 0 slot.
+                slot_index = _now;
+            } else {
+                for (level = 0; level < LEVELS; level++) {
+                    const unsigned int shift = SLOT_BITS * level;
+                    slot_index = node._expiry >> shift;
+                    if ((slot_index - (_now >> shift)) < SLOTS) {
+                        break;
+                    }
+                }
+                if (level == LEVELS) {
+                    // Out of range, hold in the last slot of the top level until it can be cascaded.
+                    level = LEVELS - 1;
+                    slot_index = (_now >> (SLOT_BITS * level)) + SLOTS - 1;
+                }
+            }
+            const unsigned int slot = slot_index & SLOT_MASK;
+            node._level = static_cast<std::uint8_t>(level);
+            node._slot = static_cast<std::uint8_t>(slot);
+            node._prev = nullptr;
+            node._next = _slots[level][slot];
+            if (node._next) {
+                node._next->_prev = &node;
+            }
+            _slots[level][slot] = &node;
+            _occupied[level] |= (1UL << slot);
+            if (!node._active) {
+                node._active = true;
+                _active_count++;
+            }
+        }
+
+        void unlink(timer_node &node) {
+            if (node._prev) {
+                node._prev->_next = node._next;
+            } else {
+                _slots[node._level][node._slot] = node._next;
+            }
+            if (node._next) {
+                node._next->_prev = node._prev;
+            }
+            if (_slots[node._level][node._slot] == nullptr) {
+                _occupied[node._level] &= ~(1UL << node._slot);
+            }
+            node._next = nullptr;
+            node._prev = nullptr;
+        }
+
+        void remove(timer_node &node) {
+            unlink(node);
+            node._active = false;
+            _active_count--;
+        }
+
+        /** Call all timers in the current level 0 slot. */
+        void expire(void) {
+            const unsigned int slot = _now & SLOT_MASK;
+            while (timer_node *node = _slots[0][slot]) {
+                if (node->_period) {
+                    // Restart from the previous expiry, rather than the current time.
+                    unlink(*node);
+                    node->_expiry += node->_period;
+                    insert(*node);
+                } else {
+                    remove(*node);
+                }
+                // Call after updating the wheel so the callback may restart or cancel the timer.
+                node->_execute(node->_context);
+            }
+        }
+
+        /** Move the timers in the current slot of each level to a lower level. */
+        void cascade(void) {
+            for (unsigned int level = LEVELS - 1; level > 0; level--) {
+                const unsigned int shift = SLOT_BITS * level;
+                if ((_now & ((static_cast<std::uint64_t>(1) << shift) - 1)) != 0) {
+                    // Not at the start of a slot at this level
+                    continue;
+                }
+                const unsigned int slot = (_now >> shift) & SLOT_MASK;
+                timer_node *node = _slots[level][slot];
+                _slots[level][slot] = nullptr;
+                _occupied[level] &= ~(1UL << slot);
+                while (node) {
+                    timer_node *next = node->_next;
+                    insert(*node);
+                    node = next;
+                }
+            }
+        }
+
+        void reprogram(void) {
+            std::uint64_t next = NEVER;
+            _timer.set_raw_time_cmp_at(next_deadline(next) ? next : NEVER);
+        }
+    };
+}
+
+#endif // #ifndef TIMER_WHEEL_HPP
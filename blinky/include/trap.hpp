@@ -0,0 +1,187 @@
+/*
+   Machine mode exception (synchronous trap) dispatch for RISC-V.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Exceptions are routed by the mcause exception code to function objects
+   bound in irq::exception_registry. The trap entry saves the interrupted
+   register file as an irq::trap_frame so handlers can emulate instructions.
+
+   Emulation handlers are provided for (see trap_emulation.hpp):
+
+   - Misaligned loads and stores    : irq::misaligned_load_emulation, irq::misaligned_store_emulation
+   - M and A extension instructions : irq::illegal_instruction_emulation
+
+   e.g.
+       static const irq::misaligned_load_emulation misaligned_load;
+       irq::exception_registry::bind<riscv::exceptions::load_address_misaligned>(misaligned_load);
+
+   In vectored mode (irq::vectored_handler) the trap entry is installed at vector table entry 0.
+
+*/
+
+#ifndef TRAP_HPP
+#define TRAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// RISC-V CSR definitions and access classes
+#include "riscv-csr.hpp"
+
+// RISC-V interrupt and exception definitions
+#include "riscv-interrupts.hpp"
+
+// Trap frame, fatal_trap() and the instruction emulation handlers
+#include "trap_emulation.hpp"
+
+// Assembler fragments for the trap entry register save/restore.
+#if __riscv_xlen == 64
+#define IRQ_TRAP_STORE "sd"
+#define IRQ_TRAP_LOAD "ld"
+#define IRQ_TRAP_REG_BYTES "8"
+#else
+#define IRQ_TRAP_STORE "sw"
+#define IRQ_TRAP_LOAD "lw"
+#define IRQ_TRAP_REG_BYTES "4"
+#endif
+// All registers except x0 (zero) and x2 (sp)
+#ifdef __riscv_32e
+#define IRQ_TRAP_SAVED_REGS "1,3,4,5,6,7,8,9,10,11,12,13,14,15"
+#else
+#define IRQ_TRAP_SAVED_REGS "1,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31"
+#endif
+
+namespace irq {
+
+    /** Stack space reserved for the trap frame, the stack is kept 16 byte aligned. */
+    static constexpr std::size_t TRAP_FRAME_SIZE = (sizeof(trap_frame) + 15) & ~static_cast<std::size_t>(15);
+
+    /** Number of entries in the exception table.
+        One entry for each standard exception code, up to the store/AMO page fault.
+     */
+    static constexpr std::uint32_t EXCEPTION_TABLE_SIZE = riscv::exceptions::store_amo_page_fault + 1;
+
+    // Machine mode trap entry.
+    // Naked function to save and restore the full register file as an irq::trap_frame.
+    // Naked functions can not be inline, 'used' avoids a warning in a file that does not install it.
+    static void trap_entry(void) __attribute__ ((naked, aligned(4), used));
+
+    // Called from trap_entry with the saved trap frame.
+    inline void trap_dispatch(trap_frame *frame);
+
+    /** Exception registry.
+     *  Holds one function object binding per exception code. The function object is
+     *  called with the irq::trap_frame of the trapping context, e.g.
+     *  `void operator()(irq::trap_frame &frame) const`.
+     *  The handler must advance frame.mepc to skip the trapping instruction.
+     *  Exceptions with no bound function object are fatal, see irq::fatal_trap().
+     */
+    class exception_registry {
+    public:
+        /** Bind a function object to an exception code.
+            This is defined as a template to prevent dynamic memory allocation.
+            @note No critical section is required, exceptions are synchronous to the executing code.
+         */
+        template<std::uint32_t CODE, class T> static void bind(T const &exception_handler);
+        /** Remove the binding for an exception code. */
+        template<std::uint32_t CODE> static void unbind(void);
+    private:
+        /** Type erased function object call */
+        struct binding {
+            void (*execute)(const void *context, trap_frame &frame);
+            const void *context;
+        };
+        // Default for exceptions with no bound function object.
+        static void unbound(const void *, trap_frame &frame) {
+            if ((frame.mcause & riscv::csr::mcause_data::exception_code::BIT_MASK) == riscv::exceptions::breakpoint) {
+                // Raised by fatal_trap() with no debugger attached.
+                halt();
+            }
+            fatal_trap();
+        }
+
+        static inline binding _bindings[EXCEPTION_TABLE_SIZE] = {
+            {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr},
+            {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr},
+            {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr},
+            {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr}, {unbound, nullptr},
+        };
+
+        friend void trap_dispatch(trap_frame *frame);
+        static inline void dispatch(trap_frame &frame) {
+            // The top bit of the mcause register indicates if this is an interrupt or exception.
+            // In vectored mode the user software interrupt also shares this entry, it is ignored.
+            if (!(frame.mcause & riscv::csr::mcause_data::interrupt::BIT_MASK)) {
+                auto code = frame.mcause & riscv::csr::mcause_data::exception_code::BIT_MASK;
+                if (code < EXCEPTION_TABLE_SIZE) {
+                    binding const &this_binding = _bindings[code];
+                    this_binding.execute(this_binding.context, frame);
+                } else {
+                    fatal_trap();
+                }
+            }
+        }
+    };
+
+    // Implement the exception registry
+
+    template<std::uint32_t CODE, class T> void exception_registry::bind(T const &exception_handler) {
+        static_assert(CODE < EXCEPTION_TABLE_SIZE, "Exception code is outside of the registry");
+        _bindings[CODE].execute = [](const void *context, trap_frame &frame)
+            {
+                // Call into the function object.
+                static_cast<T const *>(context)->operator()(frame);
+            };
+        _bindings[CODE].context = &exception_handler;
+    }
+
+    template<std::uint32_t CODE> void exception_registry::unbind(void) {
+        static_assert(CODE < EXCEPTION_TABLE_SIZE, "Exception code is outside of the registry");
+        _bindings[CODE].execute = unbound;
+        _bindings[CODE].context = nullptr;
+    }
+
+    void trap_dispatch(trap_frame *frame) {
+        frame->x[0] = 0;
+        frame->mcause = riscv::csrs.mcause.read();
+        frame->mepc = riscv::csrs.mepc.read();
+        frame->mtval = riscv::csrs.mtval.read();
+        exception_registry::dispatch(*frame);
+        // Return to the instruction after the emulated instruction
+        riscv::csrs.mepc.write(frame->mepc);
+    }
+
+    void trap_entry(void) {
+        __asm__ volatile (
+            // Save the registers in the trap frame, indexed by register number.
+            "addi   sp, sp, -%0\n"
+            ".irp   reg," IRQ_TRAP_SAVED_REGS "\n"
+            IRQ_TRAP_STORE "     x\\reg, \\reg*" IRQ_TRAP_REG_BYTES "(sp)\n"
+            ".endr\n"
+            // Save the sp of the trapping context
+            "addi   t0, sp, %0\n"
+            IRQ_TRAP_STORE "     t0, 2*" IRQ_TRAP_REG_BYTES "(sp)\n"
+            // Call the dispatcher with a pointer to the trap frame.
+            "mv     a0, sp\n"
+            "call   %1\n"
+            // Restore the registers, they may be modified by emulation.
+            ".irp   reg," IRQ_TRAP_SAVED_REGS "\n"
+            IRQ_TRAP_LOAD "     x\\reg, \\reg*" IRQ_TRAP_REG_BYTES "(sp)\n"
+            ".endr\n"
+            "addi   sp, sp, %0\n"
+            "mret\n"
+            : /* output: none */
+            : "i" (TRAP_FRAME_SIZE), "i" (trap_dispatch) /* input: frame size and dispatch function as immediates */
+            : /* clobbers: none */);
+    }
+}
+
+#undef IRQ_TRAP_STORE
+#undef IRQ_TRAP_LOAD
+#undef IRQ_TRAP_REG_BYTES
+#undef IRQ_TRAP_SAVED_REGS
+
+#endif // #ifndef TRAP_HPP
@@ -0,0 +1,385 @@
+/*
+   Instruction emulation for RISC-V machine mode exception handlers.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Decode of the trapping instruction, and emulation of misaligned loads and
+   stores and of the M and A extensions, on the irq::trap_frame saved by the
+   trap entry of trap.hpp. An instruction that is not emulated is fatal, see
+   irq::fatal_trap(). Returning would re-execute it and trap again.
+
+   The decode and emulation do not access CSRs, so they also build on a host.
+   The emulate() members return false for an instruction that is not emulated.
+
+*/
+
+#ifndef TRAP_EMULATION_HPP
+#define TRAP_EMULATION_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <type_traits>
+
+// Register width on host builds
+#include "platform.hpp"
+
+namespace irq {
+
+    using uint_xlen_t = std::conditional_t<(__riscv_xlen == 64), std::uint64_t, std::uint32_t>;
+    using int_xlen_t = std::make_signed_t<uint_xlen_t>;
+
+    /** State of the interrupted context.
+        The registers are saved and restored by the trap entry. The CSRs are read before calling
+        the handler, and mepc is written back after the handler returns.
+     */
+    struct trap_frame {
+        /** General purpose registers, indexed by register number. x[0] is always 0.
+            @note Writes to x[2] (sp) are not restored.
+         */
+        uint_xlen_t x[32];
+        /** Cause of the exception */
+        uint_xlen_t mcause;
+        /** Address of the trapping instruction. Set to the return address. */
+        uint_xlen_t mepc;
+        /** Trap value, e.g. the misaligned address */
+        uint_xlen_t mtval;
+    };
+
+#if defined(__riscv)
+    /** Halt the hart. Interrupts are disabled on trap entry, so wfi does not return to a handler. */
+    [[noreturn]] inline void halt(void) {
+        while (true) {
+            __asm__ volatile ("wfi");
+        }
+    }
+    /** Stop after an unrecoverable trap, returning would re-execute the trapping instruction.
+        Stops in the debugger if one is attached. Without a debugger ebreak raises a breakpoint
+        exception, which halts in the exception registry.
+     */
+    [[noreturn]] inline void fatal_trap(void) {
+        __asm__ volatile ("ebreak");
+        halt();
+    }
+#else
+    /** Host build, e.g. the emulation tests. There is no hart to halt. */
+    [[noreturn]] inline void halt(void) {
+        std::abort();
+    }
+    [[noreturn]] inline void fatal_trap(void) {
+        std::abort();
+    }
+#endif
+
+    /** Decode of a trapping instruction. */
+    class instruction {
+    public:
+        /** Fetch the instruction at the given address, 16 or 32 bits. */
+        explicit instruction(uint_xlen_t pc) {
+            auto halfword = reinterpret_cast<const volatile std::uint16_t *>(pc);
+            bits = halfword[0];
+            if ((bits & 0x3) == 0x3) {
+                bits |= static_cast<std::uint32_t>(halfword[1]) << 16;
+                length = 4;
+            } else {
+                length = 2;
+            }
+        }
+
+        std::uint32_t bits;
+        /** Length in bytes */
+        unsigned int length;
+
+        // 32 bit instruction fields
+        unsigned int opcode(void) const { return bits & 0x7F; }
+        unsigned int rd(void) const { return (bits >> 7) & 0x1F; }
+        unsigned int funct3(void) const { return (bits >> 12) & 0x7; }
+        unsigned int rs1(void) const { return (bits >> 15) & 0x1F; }
+        unsigned int rs2(void) const { return (bits >> 20) & 0x1F; }
+        unsigned int funct5(void) const { return bits >> 27; }
+        unsigned int funct7(void) const { return bits >> 25; }
+        /** I-type immediate, sign extended */
+        uint_xlen_t imm_i(void) const {
+            return static_cast<uint_xlen_t>(static_cast<int_xlen_t>(static_cast<std::int32_t>(bits) >> 20));
+        }
+        /** S-type immediate, sign extended */
+        uint_xlen_t imm_s(void) const {
+            // imm[11:5] is shifted down in place, a left shift of a negative value is undefined.
+            return static_cast<uint_xlen_t>(static_cast<int_xlen_t>(
+                    (static_cast<std::int32_t>(bits & 0xFE000000) >> 20) | static_cast<std::int32_t>((bits >> 7) & 0x1F)));
+        }
+
+        // 16 bit (compressed) instruction fields
+        unsigned int c_quadrant(void) const { return bits & 0x3; }
+        unsigned int c_funct3(void) const { return (bits >> 13) & 0x7; }
+        /** rd'/rs2' of CL and CS formats */
+        unsigned int c_rs2_short(void) const { return 8 + ((bits >> 2) & 0x7); }
+        /** rs1' of CL and CS formats */
+        unsigned int c_rs1_short(void) const { return 8 + ((bits >> 7) & 0x7); }
+        /** rd of CI format */
+        unsigned int c_rd(void) const { return (bits >> 7) & 0x1F; }
+        /** rs2 of CSS format */
+        unsigned int c_rs2(void) const { return (bits >> 2) & 0x1F; }
+        /** Offset of c.lw and c.sw */
+        uint_xlen_t c_lw_offset(void) const {
+            return (((bits >> 10) & 0x7) << 3) | (((bits >> 6) & 0x1) << 2) | (((bits >> 5) & 0x1) << 6);
+        }
+        /** Offset of c.lwsp */
+        uint_xlen_t c_lwsp_offset(void) const {
+            return (((bits >> 12) & 0x1) << 5) | (((bits >> 4) & 0x7) << 2) | (((bits >> 2) & 0x3) << 6);
+        }
+        /** Offset of c.swsp */
+        uint_xlen_t c_swsp_offset(void) const {
+            return (((bits >> 9) & 0xF) << 2) | (((bits >> 7) & 0x3) << 6);
+        }
+
+        static constexpr unsigned int OPCODE_LOAD = 0x03;
+        static constexpr unsigned int OPCODE_STORE = 0x23;
+        static constexpr unsigned int OPCODE_OP = 0x33;
+        static constexpr unsigned int OPCODE_AMO = 0x2F;
+        static constexpr unsigned int FUNCT7_MULDIV = 0x01;
+        static constexpr unsigned int C_FUNCT3_LW = 0x2;
+        static constexpr unsigned int C_FUNCT3_SW = 0x6;
+    };
+
+    /** Emulate a misaligned load with byte accesses.
+        Supports the base integer loads, c.lw and c.lwsp.
+     */
+    struct misaligned_load_emulation {
+        void operator()(trap_frame &frame) const {
+            if (!emulate(frame)) {
+                fatal_trap();
+            }
+        }
+        /** @retval false The instruction is not emulated, frame is unchanged. */
+        bool emulate(trap_frame &frame) const {
+            instruction insn(frame.mepc);
+            uint_xlen_t address;
+            unsigned int rd;
+            unsigned int width;
+            bool is_unsigned = false;
+            if ((insn.length == 4) && (insn.opcode() == instruction::OPCODE_LOAD)) {
+                address = frame.x[insn.rs1()] + insn.imm_i();
+                rd = insn.rd();
+                width = 1U << (insn.funct3() & 0x3);
+                is_unsigned = insn.funct3() & 0x4;
+            } else if ((insn.c_quadrant() == 0) && (insn.c_funct3() == instruction::C_FUNCT3_LW)) {
+                address = frame.x[insn.c_rs1_short()] + insn.c_lw_offset();
+                rd = insn.c_rs2_short();
+                width = 4;
+            } else if ((insn.c_quadrant() == 2) && (insn.c_funct3() == instruction::C_FUNCT3_LW)) {
+                address = frame.x[2] + insn.c_lwsp_offset();
+                rd = insn.c_rd();
+                width = 4;
+            } else {
+                // Not emulated
+                return false;
+            }
+            // Little endian byte reads
+            auto bytes = reinterpret_cast<const volatile std::uint8_t *>(address);
+            std::uint64_t value = 0;
+            for (unsigned int i = 0; i < width; i++) {
+                value |= static_cast<std::uint64_t>(bytes[i]) << (i * 8);
+            }
+            uint_xlen_t result = static_cast<uint_xlen_t>(value);
+            if (!is_unsigned && (width < sizeof(uint_xlen_t))) {
+                // Sign extend
+                const unsigned int shift = (sizeof(uint_xlen_t) - width) * 8;
+                result = static_cast<uint_xlen_t>(static_cast<int_xlen_t>(result << shift) >> shift);
+            }
+            if (rd != 0) {
+                frame.x[rd] = result;
+            }
+            frame.mepc += insn.length;
+            return true;
+        }
+    };
+
+    /** Emulate a misaligned store with byte accesses.
+        Supports the base integer stores, c.sw and c.swsp.
+     */
+    struct misaligned_store_emulation {
+        void operator()(trap_frame &frame) const {
+            if (!emulate(frame)) {
+                fatal_trap();
+            }
+        }
+        /** @retval false The instruction is not emulated, frame is unchanged. */
+        bool emulate(trap_frame &frame) const {
+            instruction insn(frame.mepc);
+            uint_xlen_t address;
+            uint_xlen_t value;
+            unsigned int width;
+            if ((insn.length == 4) && (insn.opcode() == instruction::OPCODE_STORE)) {
+                address = frame.x[insn.rs1()] + insn.imm_s();
+                value = frame.x[insn.rs2()];
+                width = 1U << (insn.funct3() & 0x3);
+            } else if ((insn.c_quadrant() == 0) && (insn.c_funct3() == instruction::C_FUNCT3_SW)) {
+                address = frame.x[insn.c_rs1_short()] + insn.c_lw_offset();
+                value = frame.x[insn.c_rs2_short()];
+                width = 4;
+            } else if ((insn.c_quadrant() == 2) && (insn.c_funct3() == instruction::C_FUNCT3_SW)) {
+                address = frame.x[2] + insn.c_swsp_offset();
+                value = frame.x[insn.c_rs2()];
+                width = 4;
+            } else {
+                // Not emulated
+                return false;
+            }
+            // Little endian byte writes
+            auto bytes = reinterpret_cast<volatile std::uint8_t *>(address);
+            for (unsigned int i = 0; i < width; i++) {
+                bytes[i] = static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (i * 8));
+            }
+            frame.mepc += insn.length;
+            return true;
+        }
+    };
+
+    /** Emulate M and A extension instructions on cores that do not implement them.
+        - M : mul, mulh, mulhsu, mulhu, div, divu, rem, remu
+        - A : lr.w, sc.w and the 32 bit AMOs. Only valid for a single hart.
+     */
+    struct illegal_instruction_emulation {
+        void operator()(trap_frame &frame) const {
+            if (!emulate(frame)) {
+                fatal_trap();
+            }
+        }
+        /** @retval false The instruction is not emulated, frame is unchanged. */
+        bool emulate(trap_frame &frame) const {
+            instruction insn(frame.mepc);
+            if (insn.length != 4) {
+                // Not emulated
+                return false;
+            }
+            uint_xlen_t result;
+            if ((insn.opcode() == instruction::OPCODE_OP) && (insn.funct7() == instruction::FUNCT7_MULDIV)) {
+                result = muldiv(insn.funct3(), frame.x[insn.rs1()], frame.x[insn.rs2()]);
+            } else if ((insn.opcode() == instruction::OPCODE_AMO) && (insn.funct3() == 0x2)) {
+                if (!amo_w(insn.funct5(), frame.x[insn.rs1()], frame.x[insn.rs2()], result)) {
+                    // Not emulated
+                    return false;
+                }
+            } else {
+                // Not emulated
+                return false;
+            }
+            if (insn.rd() != 0) {
+                frame.x[insn.rd()] = result;
+            }
+            frame.mepc += insn.length;
+            return true;
+        }
+    private:
+#if __riscv_xlen == 64
+        using uint_dxlen_t = unsigned __int128;
+        using int_dxlen_t = __int128;
+#else
+        using uint_dxlen_t = std::uint64_t;
+        using int_dxlen_t = std::int64_t;
+#endif
+        static constexpr unsigned int XLEN = sizeof(uint_xlen_t) * 8;
+        static constexpr uint_xlen_t INT_XLEN_MIN = static_cast<uint_xlen_t>(1) << (XLEN - 1);
+
+        static uint_xlen_t muldiv(unsigned int funct3, uint_xlen_t a, uint_xlen_t b) {
+            const int_xlen_t sa = static_cast<int_xlen_t>(a);
+            const int_xlen_t sb = static_cast<int_xlen_t>(b);
+            switch (funct3) {
+            case 0: // mul
+                return a * b;
+            case 1: // mulh
+                return static_cast<uint_xlen_t>((static_cast<int_dxlen_t>(sa) * static_cast<int_dxlen_t>(sb)) >> XLEN);
+            case 2: // mulhsu
+                return static_cast<uint_xlen_t>((static_cast<int_dxlen_t>(sa) * static_cast<int_dxlen_t>(b)) >> XLEN);
+            case 3: // mulhu
+                return static_cast<uint_xlen_t>((static_cast<uint_dxlen_t>(a) * static_cast<uint_dxlen_t>(b)) >> XLEN);
+            case 4: // div
+                if (b == 0) {
+                    return ~static_cast<uint_xlen_t>(0);
+                } else if ((a == INT_XLEN_MIN) && (sb == -1)) {
+                    return a;
+                }
+                return static_cast<uint_xlen_t>(sa / sb);
+            case 5: // divu
+                return (b == 0) ? ~static_cast<uint_xlen_t>(0) : (a / b);
+            case 6: // rem
+                if (b == 0) {
+                    return a;
+                } else if ((a == INT_XLEN_MIN) && (sb == -1)) {
+                    return 0;
+                }
+                return static_cast<uint_xlen_t>(sa % sb);
+            default: // remu
+                return (b == 0) ? a : (a % b);
+            }
+        }
+
+        // LR/SC reservation. Cleared by SC.
+        static inline uint_xlen_t _reservation_address;
+        static inline bool _reservation_valid = false;
+
+        static bool amo_w(unsigned int funct5, uint_xlen_t address, uint_xlen_t source, uint_xlen_t &result) {
+            if (!is_amo_w(funct5) || (address & 0x3)) {
+                // Unknown AMO, or a misaligned access would trap from within this trap.
+                return false;
+            }
+            // Interrupts are disabled on trap entry, so the read-modify-write is atomic on a single hart.
+            auto word = reinterpret_cast<volatile std::uint32_t *>(address);
+            const std::uint32_t src = static_cast<std::uint32_t>(source);
+            if (funct5 == 0x03) { // sc.w
+                if (_reservation_valid && (_reservation_address == address)) {
+                    *word = src;
+                    result = 0;
+                } else {
+                    result = 1;
+                }
+                _reservation_valid = false;
+                return true;
+            }
+            const std::uint32_t old_value = *word;
+            std::uint32_t new_value;
+            switch (funct5) {
+            case 0x02: // lr.w
+                _reservation_address = address;
+                _reservation_valid = true;
+                result = sign_extend(old_value);
+                return true;
+            case 0x01: new_value = src; break; // amoswap.w
+            case 0x00: new_value = old_value + src; break; // amoadd.w
+            case 0x04: new_value = old_value ^ src; break; // amoxor.w
+            case 0x0C: new_value = old_value & src; break; // amoand.w
+            case 0x08: new_value = old_value | src; break; // amoor.w
+            case 0x10: // amomin.w
+                new_value = (static_cast<std::int32_t>(src) < static_cast<std::int32_t>(old_value)) ? src : old_value;
+                break;
+            case 0x14: // amomax.w
+                new_value = (static_cast<std::int32_t>(src) > static_cast<std::int32_t>(old_value)) ? src : old_value;
+                break;
+            case 0x18: new_value = (src < old_value) ? src : old_value; break; // amominu.w
+            case 0x1C: new_value = (src > old_value) ? src : old_value; break; // amomaxu.w
+            default:
+                return false;
+            }
+            *word = new_value;
+            result = sign_extend(old_value);
+            return true;
+        }
+
+        /** lr.w, sc.w and the 32 bit AMOs, checked before the memory is accessed. */
+        static constexpr bool is_amo_w(unsigned int funct5) {
+            switch (funct5) {
+            case 0x00: case 0x01: case 0x02: case 0x03: case 0x04:
+            case 0x08: case 0x0C: case 0x10: case 0x14: case 0x18: case 0x1C:
+                return true;
+            default:
+                return false;
+            }
+        }
+        static uint_xlen_t sign_extend(std::uint32_t value) {
+            return static_cast<uint_xlen_t>(static_cast<int_xlen_t>(static_cast<std::int32_t>(value)));
+        }
+    };
+}
+
+#endif // #ifndef TRAP_EMULATION_HPP
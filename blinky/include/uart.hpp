@@ -0,0 +1,186 @@
+/*
+   Interrupt driven UART driver for the sifive_uart0 device.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Receive and transmit data is buffered in lock-free ring buffers, the
+   hardware FIFOs are serviced from the UART interrupt:
+
+   - Receive  : The rxwm interrupt drains the receive FIFO into the receive buffer.
+   - Transmit : write() only fills the transmit buffer and enables the txwm interrupt.
+                The txwm interrupt refills the transmit FIFO in one burst, without
+                polling the full flag, and is disabled when the buffer is empty.
+
+   The CPU can stay in wfi between FIFO refills.
+
+   e.g.
+       driver::uart<UART0_ADDR> uart(115200);
+       static const auto uart_handler = [&] (void) { uart.handle_interrupt(); };
+       plic.bind<UART0_SOURCE>(uart_handler);
+       plic.enable<UART0_SOURCE>(1);
+       uart.write("hello\r\n");
+
+*/
+
+#ifndef UART_HPP
+#define UART_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// MMIO register access policies
+#include "mmio_device.hpp"
+
+// Lock-free ring buffers
+#include "ring_buffer.hpp"
+
+// Clock tree configuration
+#include "clock_config.hpp"
+
+// MMIO Device interface definition, generated by tools/svd2mmio.py
+#include "device/sifive_uart0_0_mmio_dev.hpp"
+
+namespace driver {
+
+    /** UART parameters.
+        The UART is clocked by tlclk, CLOCK::CORE_CLOCK_HZ.
+        @tparam CLOCK Clock configuration, e.g. driver::pll_clock_config<>.
+     */
+    template<class CLOCK=default_clock_config> struct uart_config : CLOCK {
+        // Ring buffer sizes, must be a power of two.
+        static constexpr std::size_t RX_BUFFER_SIZE=128;
+        static constexpr std::size_t TX_BUFFER_SIZE=256;
+        // txwm is pending while the transmit FIFO has fewer than TX_WATERMARK entries.
+        // The remaining entries cover the interrupt latency at high baud rates.
+        static constexpr unsigned int TX_WATERMARK=2;
+        // rxwm is pending while the receive FIFO has more than RX_WATERMARK entries.
+        // The device has no receive timeout, so a higher watermark would hold back the last bytes.
+        static constexpr unsigned int RX_WATERMARK=0;
+    };
+    /** SiFive-hifive1-revb UART parameters
+     */
+    using default_uart_config = uart_config<>;
+
+    /** Interrupt driven UART driver.
+        @tparam BASE_ADDR Base address of the UART device.
+        @tparam CONFIG    Clock, buffer sizes and watermarks.
+        Template ACCESS is the MMIO access policy, e.g. mmio_device::direct_access, or mmio_sim::sim_access on a host.
+     */
+    template<std::uintptr_t BASE_ADDR,
+             class CONFIG=default_uart_config,
+             template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class uart {
+        using txdata_r = mmio_param::sifive_uart0_0::txdata_r;
+        using rxdata_r = mmio_param::sifive_uart0_0::rxdata_r;
+        using ip_r = mmio_param::sifive_uart0_0::ip_r;
+    public:
+        /** Depth of the hardware transmit and receive FIFOs */
+        static constexpr unsigned int FIFO_DEPTH = 8;
+        static_assert((CONFIG::TX_WATERMARK > 0) && (CONFIG::TX_WATERMARK < FIFO_DEPTH), "Invalid transmit watermark");
+        static_assert(CONFIG::RX_WATERMARK < FIFO_DEPTH, "Invalid receive watermark");
+        /** Number of bytes that can be written to the transmit FIFO when txwm is pending,
+            without checking the full flag.
+         */
+        static constexpr unsigned int TX_BURST = FIFO_DEPTH - CONFIG::TX_WATERMARK + 1;
+
+        /** Enable the UART, 8 data bits, no parity, 1 stop bit.
+            The receive interrupt is enabled, the UART source must be enabled in the PLIC.
+         */
+        explicit uart(std::uint32_t baud_rate) {
+            set_baud_rate(baud_rate);
+            _dev.txctrl.modify(_dev.txctrl.txen.value(true),
+                               _dev.txctrl.nstop.value(false),
+                               _dev.txctrl.txcnt.value(CONFIG::TX_WATERMARK));
+            _dev.rxctrl.modify(_dev.rxctrl.rxen.value(true),
+                               _dev.rxctrl.rxcnt.value(CONFIG::RX_WATERMARK));
+            _dev.ie.modify(_dev.ie.txwm.value(false),
+                           _dev.ie.rxwm.value(true));
+        }
+        // Boilerplate delete defaults - non copyable class
+        uart(const uart&) = delete;
+        uart &operator=(const uart&) = delete;
+        uart(uart&&) = delete;
+        uart &operator=(uart&&) = delete;
+
+        /** Set the baud rate, e.g. after changing the core clock */
+        void set_baud_rate(std::uint32_t baud_rate, std::uint32_t clock_hz=CONFIG::CORE_CLOCK_HZ) {
+            // baud_rate = clock_hz / (div + 1)
+            _dev.div.write((clock_hz + baud_rate/2) / baud_rate - 1);
+        }
+
+        /** Queue data for transmission. Does not block.
+            @retval The number of bytes queued, less than length if the transmit buffer is full.
+         */
+        std::size_t write(const std::uint8_t *data, std::size_t length) {
+            const std::size_t count = _tx.push(data, length);
+            if (count) {
+                // The interrupt is taken immediately if the transmit FIFO is below the watermark.
+                _dev.ie.txwm.set();
+            }
+            return count;
+        }
+        template<std::size_t N> std::size_t write(const std::uint8_t (&data)[N]) {
+            return write(data, N);
+        }
+        std::size_t write(std::string_view text) {
+            return write(reinterpret_cast<const std::uint8_t *>(text.data()), text.size());
+        }
+
+        /** Read received data. Does not block.
+            @retval The number of bytes read.
+         */
+        std::size_t read(std::uint8_t *data, std::size_t length) {
+            return _rx.pop(data, length);
+        }
+
+        /** Number of received bytes that can be read */
+        std::size_t rx_available(void) const {
+            return _rx.size();
+        }
+        /** Free space in the transmit buffer */
+        std::size_t tx_space(void) const {
+            return _tx.space();
+        }
+        /** Number of received bytes dropped as the receive buffer was full */
+        std::size_t rx_overruns(void) const {
+            return _rx_overruns.load(std::memory_order_relaxed);
+        }
+
+        /** Service the FIFOs. Called from the UART PLIC source handler. */
+        void handle_interrupt(void) {
+            const std::uint32_t pending = _dev.ip.read();
+            if (pending & ip_r::rxwm_f::bit_mask) {
+                // Drain the receive FIFO, each read pops one entry.
+                for (std::uint32_t value = _dev.rxdata.read();
+                     !(value & rxdata_r::empty_f::bit_mask);
+                     value = _dev.rxdata.read()) {
+                    if (!_rx.push(static_cast<std::uint8_t>(value & rxdata_r::data_f::bit_mask))) {
+                        _rx_overruns.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+            if (pending & ip_r::txwm_f::bit_mask) {
+                // The FIFO is below the watermark, so there is space for TX_BURST bytes.
+                std::uint8_t burst[TX_BURST];
+                const std::size_t count = _tx.pop(burst, TX_BURST);
+                for (std::size_t i = 0; i < count; i++) {
+                    _dev.txdata.write(burst[i]);
+                }
+                if (_tx.empty()) {
+                    // Re-enabled by write()
+                    _dev.ie.txwm.clear();
+                }
+            }
+        }
+
+    private:
+        sifive_uart0_0_dev<BASE_ADDR, ACCESS> _dev;
+        irq::ring_buffer<CONFIG::RX_BUFFER_SIZE> _rx;
+        irq::ring_buffer<CONFIG::TX_BUFFER_SIZE> _tx;
+        std::atomic<std::uint32_t> _rx_overruns{0};
+    };
+}
+
+#endif // #ifndef UART_HPP
@@ -6,6 +6,7 @@
 #ifndef UTIL_HPP
 #define UTIL_HPP
 
+#include <cstddef>
 #include <cstdint>
 
 namespace util {
@@ -16,7 +17,7 @@ namespace util {
     }
 
     /** Compile time check for a power of two number */
-    static constexpr bool is_power_of_two(size_t SIZE) {
+    static constexpr bool is_power_of_two(std::size_t SIZE) {
         return SIZE && ((SIZE & (SIZE-1)) == 0);
     }
 }
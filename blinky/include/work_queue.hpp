@@ -0,0 +1,115 @@
+/*
+   Deferred interrupt work queue (bottom half).
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   Interrupt handlers push small function objects onto the queue,
+   the idle loop drains the queue and executes them outside of interrupt context.
+
+*/
+
+#ifndef WORK_QUEUE_HPP
+#define WORK_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+// Compile time checks
+#include "util.hpp"
+
+namespace irq {
+
+    /** Lock-free queue of deferred work items.
+
+        Multiple producers (interrupt handlers, including nested handlers) and a single consumer (the idle loop).
+        Slots are reserved with a compare and swap on the head index, so a producer preempted
+        by a higher priority interrupt does not block that interrupt.
+        Work items are stored by value in a fixed size slot, no dynamic memory allocation is used.
+
+        @tparam SIZE         Number of slots. Must be a power of two.
+        @tparam STORAGE_SIZE Bytes of storage for each function object, e.g. the captures of a lambda.
+     */
+    template<std::size_t SIZE, std::size_t STORAGE_SIZE=2*sizeof(void*)> class work_queue {
+    public:
+        static_assert(util::is_power_of_two(SIZE), "The work queue size must be a power of two");
+
+        work_queue(void) {}
+        // Boilerplate delete defaults - non copyable class
+        work_queue(const work_queue&) = delete;
+        work_queue &operator=(const work_queue&) = delete;
+        work_queue(work_queue&&) = delete;
+        work_queue &operator=(work_queue&&) = delete;
+
+        /** Push a function object onto the queue. Called from interrupt context.
+            @retval false The queue is full, the work item was not queued.
+         */
+        template<class T> bool push(T const &work) {
+            static_assert(sizeof(T) <= STORAGE_SIZE, "The work item does not fit in the work queue slot storage");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "The work item alignment is not supported");
+            static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                          "Work items are copied into the queue and never destroyed");
+            // Reserve a slot
+            std::uint32_t head = _head.load(std::memory_order_relaxed);
+            do {
+                if ((head - _tail.load(std::memory_order_acquire)) >= SIZE) {
+                    return false;
+                }
+            } while (!_head.compare_exchange_weak(head, head + 1,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_relaxed));
+            // Fill the slot, then publish it to the consumer.
+            slot &this_slot = _slots[head & (SIZE-1)];
+            new (this_slot.storage) T(work);
+            this_slot.execute = [](void *storage)
+                {
+                    // Call into the function object.
+                    (*static_cast<T *>(storage))();
+                };
+            this_slot.ready.store(true, std::memory_order_release);
+            return true;
+        }
+
+        /** Execute all queued work items. Called from the idle loop.
+            @retval The number of work items executed.
+         */
+        std::size_t drain(void) {
+            std::size_t count = 0;
+            std::uint32_t tail = _tail.load(std::memory_order_relaxed);
+            while (tail != _head.load(std::memory_order_acquire)) {
+                slot &this_slot = _slots[tail & (SIZE-1)];
+                // The slot may be reserved by an interrupted producer, but not filled yet.
+                if (!this_slot.ready.load(std::memory_order_acquire)) {
+                    break;
+                }
+                this_slot.execute(this_slot.storage);
+                this_slot.ready.store(false, std::memory_order_relaxed);
+                // Release the slot to the producers.
+                _tail.store(++tail, std::memory_order_release);
+                count++;
+            }
+            return count;
+        }
+
+        /** Check if there is any queued work. */
+        bool empty(void) const {
+            return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire);
+        }
+
+    private:
+        struct slot {
+            alignas(std::max_align_t) unsigned char storage[STORAGE_SIZE];
+            void (*execute)(void *storage);
+            std::atomic<bool> ready{false};
+        };
+        slot _slots[SIZE];
+        // Free running indexes, the slot is the index modulo SIZE.
+        std::atomic<std::uint32_t> _head{0};
+        std::atomic<std::uint32_t> _tail{0};
+    };
+}
+
+#endif // #ifndef WORK_QUEUE_HPP
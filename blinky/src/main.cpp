@@ -6,9 +6,11 @@
 
    Example of Modern C++ programming for the RISC-V processor
 
-   Setup a periodic timer using std::chrono and execute a lambda
-   function as an interrupt handler to perform the classic one second
-   LED blink exercise.
+   The classic one second LED blink exercise, generated by the PWM
+   hardware with the period and duty set using std::chrono.
+   The core runs from the PLL at 320MHz.
+   A periodic timer executes a lambda function as an interrupt handler
+   to write a tick to the UART console.
 
 */
 
@@ -23,163 +25,212 @@
 // freedom-e-sdk/bsp/sifive-hifive1-revb/design.svd
 #include "device/sifive_gpio0_0_mmio_dev.hpp"
 
+// Typed GPIO pins
+#include "gpio.hpp"
+
+// Platform-level interrupt controller
+#include "device/riscv_plic0_mmio_dev.hpp"
+#include "plic.hpp"
+
+// GPIO edge interrupts
+#include "gpio_irq.hpp"
+
+// Interrupt driven UART
+#include "uart.hpp"
+
+// Hardware PWM
+#include "pwm.hpp"
+
+// Clock setup, the core clock from the PLL
+#include "prci.hpp"
+
 // Generic machine mode timer driver
 #include "timer.hpp"
 
+// Software timers multiplexed on the machine mode timer
+#include "timer_wheel.hpp"
+
+// High resolution mcycle clock
+#include "cycle_clock.hpp"
+
 // Misc utils
 #include "util.hpp"
 
+// Machine mode interrupt handler installation
+#include "irq.hpp"
+
+// Deferred interrupt work
+#include "work_queue.hpp"
+
 // Base address for GPIO MMIO
 static constexpr uintptr_t SIFIVE_GPIO0_0 = 0x10012000;
 // LED location, from freedom-e-sdk/bsp/sifive-hifive1-revb/core.dts
 static constexpr int LED_RED=22;
 static constexpr int LED_GREEN=19;
 static constexpr int LED_BLUE=21;
-static constexpr unsigned int LED_MASK_WHITE=util::bitmask(LED_RED)|util::bitmask(LED_GREEN)|util::bitmask(LED_BLUE);
+// PWM1 drives the LEDs on I/O function 1: green PWM1_1, blue PWM1_2, red PWM1_3
+static constexpr uintptr_t SIFIVE_PWM0_1 = 0x10025000;
+static constexpr unsigned int PWM_GREEN=1;
+static constexpr unsigned int PWM_BLUE=2;
+static constexpr unsigned int PWM_RED=3;
+// Button input, header pin D2, active low with the internal pull-up
+static constexpr int BUTTON=18;
+// Base address for the PLIC MMIO
+static constexpr uintptr_t RISCV_PLIC0 = 0x0C000000;
+// UART0, connected to the debug USB serial port, from freedom-e-sdk/bsp/sifive-hifive1-revb/core.dts
+static constexpr uintptr_t SIFIVE_UART0_0 = 0x10013000;
+static constexpr unsigned int UART0_SOURCE=3;
+static constexpr int UART0_RX=16;
+static constexpr int UART0_TX=17;
+// Base address for the PRCI MMIO
+static constexpr uintptr_t SIFIVE_FE310_G000_PRCI = 0x10008000;
+
+// Core clock from the PLL, the divisors are found and checked at compile time.
+// The UART baud rate, PWM timing and cycle clock use this configuration.
+using clock_config = driver::pll_clock_config<320000000>;
 
 // Address of timer
 struct mtimer_address_spec {
     static constexpr std::uintptr_t MTIMECMP_ADDR = 0x2000000 + 0x4000;
     static constexpr std::uintptr_t MTIME_ADDR = 0x2000000 + 0xBFF8;
 };
-struct mtimer_timer_config {
-    // See
-    // freedom-e-sdk/bsp/sifive-hifive1-revb/core.dts
-    // psdlfaltclk: clock@6
-    // Fixed to 32Khz
-    static constexpr unsigned int MTIME_FREQ_HZ=32768;
-};
-
 
-// Place the IRQ related code in a seperate namespace
-namespace irq {
-    // Machine mode interrupt service routine
-    // Defined as an interrupt function to ensure correct 'mret' exit is generated.
-    static void entry(void) __attribute__ ((interrupt ("machine")));
-
-    /** IRQ Handler class. Allows a lambda function (or other function
-     * object) to be registered as the machine mode IRQ hander.
-     */
-    class handler {
-    public:
-        /** Create an IRQ handler class to install a 
-            function as the machine mode irq handler */
-        template<class T> handler(T const &isr_handler);
-        // Boilerplate delete defaults - non copyable class
-        handler(const handler&) = delete;
-        handler &operator=(const handler&) = delete;
-        handler(handler&&) = delete;
-        handler &operator=(handler&&) = delete;
-    private :
-        static inline  void (*_execute_handler)(void); 
-        // Trampoline function is required to bridge from the entry point
-        // function declared with specific attributes and alignments to this class member.
-        friend void entry(void);
-        static inline void handler_entry(void) {
-            _execute_handler();
-        }
-    };
-}
 
 int main(void) {
 
     // Device drivers
-    driver::sifive_gpio0_0_dev<SIFIVE_GPIO0_0> gpio_dev;
-    driver::timer<mtimer_address_spec, mtimer_timer_config> mtimer;
+    driver::timer<mtimer_address_spec, clock_config> mtimer;
+    // Switch to the PLL before the peripheral clock dividers are set.
+    driver::prci<SIFIVE_FE310_G000_PRCI> prci;
+    prci.use_pll<clock_config>(mtimer);
+    // The output registers are shadowed in RAM, so the pin updates are a single bus write.
+    // The RAM copies are loaded at construction, keeping the boot loader UART0 iof_en pins.
+    driver::sifive_gpio0_0_dev<SIFIVE_GPIO0_0, mmio_device::shadow_access> gpio_dev;
+    // The white LED, the mask is computed at compile time.
+    driver::pin_group<decltype(gpio_dev), LED_RED, LED_GREEN, LED_BLUE> led_white(gpio_dev);
+    // 2 second LED blink period. The counter scale and period are computed at compile time.
+    driver::pwm<SIFIVE_PWM0_1, driver::pwm_config<clock_config>> led_pwm(std::chrono::seconds{2});
+    driver::riscv_plic0_dev<RISCV_PLIC0> plic_dev;
+    driver::plic<decltype(plic_dev)> plic(plic_dev);
+    driver::gpio_irq<decltype(gpio_dev), decltype(plic)> gpio_irq(gpio_dev, plic);
+    driver::uart<SIFIVE_UART0_0, driver::uart_config<clock_config>> uart(115200);
 
     // Device Setup       
 
+    // Calibrate the mcycle clock against mtime, for nanosecond resolution timing.
+    driver::cycle_clock<decltype(mtimer), driver::cycle_clock_config<clock_config>>::calibrate(mtimer);
+
     // Save the timer value at this time.
     auto timestamp = mtimer.get_time<driver::timer<>::timer_ticks>().count();
-    // Setup timer for 1 second interval
-    // std::chrono allows us to specify the time units in
-    // We could even use `1 s` via chrono::literals
-    // This comes at no cost as the timer driver has defined it's hardware clock period as a type timer::timer_ticks
-    // and the conversion via std::chrono::duration_cast<timer_ticks>() is done at compile time
-    mtimer.set_time_cmp(std::chrono::seconds{1});
+    // Software timers. The comparator is only programmed for the next timer deadline (tickless).
+    driver::timer_wheel<decltype(mtimer)> timer_wheel(mtimer);
+
+    // LEDs on for 1 second of each period, the LEDs are active low so the PWM outputs are inverted.
+    led_pwm.set_duty<PWM_RED>(std::chrono::seconds{1});
+    led_pwm.set_duty<PWM_GREEN>(std::chrono::seconds{1});
+    led_pwm.set_duty<PWM_BLUE>(std::chrono::seconds{1});
+    gpio_dev.out_xor |= led_white.MASK;
+    // Connect the LEDs to the PWM, no interrupt or CPU time is needed for the blink.
+    led_white.iof<1>();
 
-    // Enable GPIO
-    gpio_dev.output_val &= ~(LED_MASK_WHITE);
-    gpio_dev.output_en  |=  (LED_MASK_WHITE);
+    // Work deferred from the interrupt handlers, executed by the idle loop.
+    irq::work_queue<8> deferred_work;
 
-    // The periodic interrupt lambda function.
+    // The periodic tick timer lambda function, called from the timer interrupt handler.
     // The context (drivers etc) is captured via reference using [&]
-    static const auto handler = [&] (void) 
+    static const auto tick = [&] (void) 
         {
-            // In RISC-V the mcause register stores the cause of any interrupt or exception.            
-            auto this_cause = riscv::csrs.mcause.read();
-            // For simplicity non-vectored interrupt mode is used. 
-            // The top bit of the mcause register indicates if this is an interrupt or exception.
-            if (this_cause &  riscv::csr::mcause_data::interrupt::BIT_MASK) {
-                this_cause &= 0xFF;
-                // De-multiplex the interrupt
-                // The cause register LSBs hold an integer value that represents the interrupt source
-                switch (this_cause) {
-                case riscv::interrupts::mti :
-                    // A machine timer interrupt
-                    // RISC-V machine mode timer interrupts are not repeating.
-                    // Set the timer compare register to the current time + one second
-                    mtimer.set_time_cmp(std::chrono::seconds{1});
-                    // Save the timestamp as a raw counter in units of the hardware counter.
-                    // While there is quite a bit of code here, it can be resolved at compile time to a simple
-                    // MMIO register read.
-                    timestamp = mtimer.get_time<driver::timer<>::timer_ticks>().count();
-                    // Xor to invert. This can be compiled to a write to the toggle register via operator overloading.
-                    gpio_dev.output_val ^= (LED_MASK_WHITE);
-                    break;
-                }
-            }
-            // TODO - else handle exceptions - for simplicity exceptions are not handled.
+            // Save the timestamp as a raw counter in units of the hardware counter.
+            // While there is quite a bit of code here, it can be resolved at compile time to a simple
+            // MMIO register read.
+            timestamp = mtimer.get_time<driver::timer<>::timer_ticks>().count();
+            // Defer the UART write to the idle loop to keep the ISR short.
+            deferred_work.push([&uart] (void) 
+                {
+                    uart.write("tick\r\n");
+                });
         };
+    static driver::timer_node tick_timer(tick);
 
-    // Install the above lambda function as the machine mode IRQ handler.
-    irq::handler irq_handler(handler);
+    // The timer interrupt lambda function.
+    static const auto timer_handler = [&] (void) 
+        {
+            // A machine timer interrupt
+            // Vectored interrupt mode is used, so the mcause register does not need to be
+            // read and de-multiplexed. The vector table entry for mti jumps directly here.
+            // RISC-V machine mode timer interrupts are not repeating.
+            // The wheel calls the expired timers and sets the timer compare register to the next deadline.
+            timer_wheel.process();
+        };
+
+    // The button lambda function, called on the falling edge of the button pin.
+    // The edge is latched by the GPIO device, the pin is not polled.
+    static unsigned int button_presses = 0;
+    static const auto button_handler = [&] (void) 
+        {
+            button_presses++;
+        };
+    gpio_dev.pue |= util::bitmask(BUTTON);
+    gpio_irq.attach<BUTTON, driver::edge::fall>(button_handler);
+
+    // The UART lambda function, moves data between the UART FIFOs and the ring buffers.
+    static const auto uart_handler = [&] (void) 
+        {
+            uart.handle_interrupt();
+        };
+    // Connect the UART pins to the UART (I/O function 0).
+    driver::pin_group<decltype(gpio_dev), UART0_RX, UART0_TX>(gpio_dev).iof<0>();
+    plic.bind<UART0_SOURCE>(uart_handler);
+    plic.enable<UART0_SOURCE>(1);
+    uart.write("blinky\r\n");
+
+    // The external interrupt lambda function.
+    static const auto external_handler = [&] (void) 
+        {
+            // Claim and complete the PLIC sources, the GPIO sources call gpio_irq.
+            plic.dispatch();
+        };
+
+    // Install the above lambda functions as the machine mode timer and external IRQ handlers.
+    // The vector table is built at compile time and written to mtvec in vectored mode.
+    // Both handlers call function objects through pointers (the timer wheel nodes and the PLIC bindings),
+    // which can not be inlined, so they use the standard entry rather than irq::inline_entry.
+    irq::vectored_handler irq_handler(irq::make_vector<riscv::interrupts::mti>(timer_handler),
+                                      irq::make_vector<riscv::interrupts::mei>(external_handler));
+
+    // The FE310 does not support misaligned access in hardware.
+    // Emulate misaligned loads and stores in the exception handler rather than livelock on the trap.
+    static const irq::misaligned_load_emulation misaligned_load;
+    static const irq::misaligned_store_emulation misaligned_store;
+    irq::exception_registry::bind<riscv::exceptions::load_address_misaligned>(misaligned_load);
+    irq::exception_registry::bind<riscv::exceptions::store_amo_address_misaligned>(misaligned_store);
+
+    // Setup timer for 1 second interval
+    // std::chrono allows us to specify the time units in
+    // We could even use `1 s` via chrono::literals
+    // This comes at no cost as the timer driver has defined it's hardware clock period as a type timer::timer_ticks
+    // and the conversion via std::chrono::duration_cast<timer_ticks>() is done at compile time
+    // The period is advanced from the previous deadline, so the ISR latency does not cause drift.
+    timer_wheel.start_periodic(tick_timer, std::chrono::seconds{1});
 
     // Enable interrupts
     riscv::csrs.mie.mti.set();
+    riscv::csrs.mie.mei.set();
     // Global interrupt enable
     riscv::csrs.mstatus.mie.set();
 
-    // Busy loop
+    // Idle loop
     do {
-        __asm__ volatile ("wfi");  
+        // Execute the work deferred by the interrupt handlers.
+        deferred_work.drain();
+        // Echo the UART input.
+        std::uint8_t echo[16];
+        const std::size_t space = uart.tx_space();
+        uart.write(echo, uart.read(echo, (space < sizeof(echo)) ? space : sizeof(echo)));
+        // Sleep until the next timer deadline, there is no periodic tick.
+        // The deferred work is checked with interrupts disabled so work queued by an interrupt is not missed.
+        timer_wheel.idle([&] (void) { return !deferred_work.empty() || (uart.rx_available() != 0); });
     } while (true);
 
     return 0; // Never executed
 }
-
-// Implement the IRQ handler
-namespace irq {
-
-    // IRQ handler constructor
-    // This is defined as a template to prevent dynamic memory allocation
-    // by ensuring code can be generated according to the lambda function type defined in main.
-    // That ensures a std::function() does not need to be used as a generic function call interface.
-    template<class T> handler::handler(T const &isr_handler) {
-        // This will call the C++ function object method that represents the lamda function above.
-        // This is required to provide the context of the function call that is captured by the lambda.
-        // A RISC-V optimization uses the MSCRATCH register to hold the function object context pointer.
-        _execute_handler = [](void)
-            {
-                // Read the context from the interrupt scratch register.
-                uintptr_t isr_context = riscv::csrs.mscratch.read();
-                // Call into the lambda function.
-                return ((T *)isr_context)->operator()();
-            };
-        // Get a pointer to the IRQ context and save in the interrupt scratch register.
-        uintptr_t isr_context = (uintptr_t)&isr_handler;
-        riscv::csrs.mscratch.write( reinterpret_cast<std::uintptr_t>(isr_context) );
-        // Write the entry() function to the mtvec register to install our IRQ handler.
-        riscv::csrs.mtvec.write( reinterpret_cast<std::uintptr_t>(entry) );
-    }      
-    
-#pragma GCC push_options
-// Force the alignment for mtvec.BASE.
-// A 'xC' extension program could be aligned to to bytes.
-#pragma GCC optimize ("align-functions=4")
-    static void entry(void)  {
-        // Jump into the function defined within the irq::handler class.
-        handler::handler_entry();
-    }
-#pragma GCC pop_options
-}
@@ -0,0 +1,384 @@
+#!/usr/bin/env python3
+"""
+   Generate MMIO register headers from a CMSIS SVD file.
+   SPDX-License-Identifier: Unlicense
+
+   https://five-embeddev.com/
+
+   For each peripheral three headers are written to the output directory:
+
+   - <peripheral>_mmio_param.hpp : mmio_param:: register and field offsets, widths and masks.
+   - <peripheral>_mmio_regs.hpp  : mmio_regs:: register classes, with a mmio_device::reg_field
+                                   member for each field.
+   - <peripheral>_mmio_dev.hpp   : driver::<peripheral>_dev, one member per register.
+
+   Register arrays named "name[%s]" become register classes indexed by a template
+   parameter. Other register arrays ("name%s") are expanded to one register per element.
+
+   Registers can be given a separate access policy, e.g. to shadow write-mostly
+   registers with mmio_device::shadow_access:
+
+       svd2mmio.py design.svd include/device --shadow sifive_gpio0_0=output_en,output_val,iof_en
+
+"""
+
+import argparse
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+# C++ keywords that can not be used as member names.
+CXX_KEYWORDS = {
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+    "case", "catch", "char", "class", "compl", "const", "constexpr", "const_cast", "continue",
+    "decltype", "default", "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit",
+    "export", "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int", "long",
+    "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or",
+    "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "return", "short",
+    "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template",
+    "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union",
+    "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+    # Names used by mmio_device::reg and reg_field
+    "read", "write", "set", "clr", "clear", "toggle", "swap", "modify", "mask", "format", "extract",
+    "value", "sync", "address",
+}
+
+
+def parse_int(text):
+    """ SVD scaled non-negative integer: decimal, 0x hex or # binary. """
+    text = text.strip().lower()
+    if text.startswith("#"):
+        return int(text[1:], 2)
+    return int(text, 0)
+
+
+def child_text(node, tag, default=None):
+    child = node.find(tag)
+    if child is None or child.text is None:
+        return default
+    return " ".join(child.text.split())
+
+
+def cxx_name(name):
+    """ Lower case C++ identifier for an SVD name. """
+    name = re.sub(r"[^0-9a-zA-Z_]", "_", name).lower()
+    if name[0].isdigit():
+        name = "_" + name
+    if name in CXX_KEYWORDS:
+        name = name + "_"
+    return name
+
+
+def comment(text):
+    """ Description as a single line C comment body. """
+    return (text or "").replace("*/", "* /")
+
+
+def uint_type(bits):
+    for size in (8, 16, 32, 64):
+        if bits <= size:
+            return "std::uint%d_t" % size
+    raise ValueError("Unsupported width %d" % bits)
+
+
+def field_type(bits):
+    return "bool" if bits == 1 else uint_type(bits)
+
+
+class Field:
+    def __init__(self, node):
+        self.name = cxx_name(child_text(node, "name"))
+        self.description = child_text(node, "description", self.name)
+        bit_range = child_text(node, "bitRange")
+        if bit_range is not None:
+            msb, lsb = [int(x) for x in bit_range.strip("[]").split(":")]
+            self.bit_offset, self.bit_width = lsb, msb - lsb + 1
+        elif node.find("lsb") is not None:
+            self.bit_offset = parse_int(child_text(node, "lsb"))
+            self.bit_width = parse_int(child_text(node, "msb")) - self.bit_offset + 1
+        else:
+            self.bit_offset = parse_int(child_text(node, "bitOffset"))
+            self.bit_width = parse_int(child_text(node, "bitWidth", "1"))
+
+    @property
+    def bit_mask(self):
+        return ((1 << self.bit_width) - 1) << self.bit_offset
+
+
+class Register:
+    def __init__(self, name, description, offset, size, fields, dim=1, dim_increment=0):
+        self.name = name
+        self.description = description
+        self.offset = offset
+        self.size = size
+        self.fields = fields
+        self.dim = dim
+        self.dim_increment = dim_increment
+
+
+def dim_indices(node, dim):
+    dim_index = child_text(node, "dimIndex")
+    if dim_index is None:
+        return [str(i) for i in range(dim)]
+    if "-" in dim_index and "," not in dim_index:
+        first, last = dim_index.split("-")
+        if first.isdigit():
+            return [str(i) for i in range(int(first), int(last) + 1)]
+        return [chr(c) for c in range(ord(first), ord(last) + 1)]
+    return dim_index.split(",")
+
+
+def parse_registers(node, default_size, prefix="", base_offset=0):
+    """ Flatten the registers and clusters of a peripheral. """
+    registers = []
+    for child in node:
+        if child.tag not in ("register", "cluster"):
+            continue
+        name = child_text(child, "name")
+        description = child_text(child, "description", name)
+        offset = base_offset + parse_int(child_text(child, "addressOffset"))
+        size = parse_int(child_text(child, "size", str(default_size)))
+        dim = parse_int(child_text(child, "dim", "1"))
+        dim_increment = parse_int(child_text(child, "dimIncrement", "0"))
+        if child.tag == "cluster":
+            for i, index in enumerate(dim_indices(child, dim) if dim > 1 else [""]):
+                cluster_name = name.replace("[%s]", index).replace("%s", index)
+                registers += parse_registers(child, size, prefix + cxx_name(cluster_name) + "_",
+                                             offset + i * dim_increment)
+            continue
+        fields_node = child.find("fields")
+        fields = [Field(f) for f in fields_node.findall("field")] if fields_node is not None else []
+        # A single field covering the whole register adds nothing to the register access.
+        if len(fields) == 1 and fields[0].bit_offset == 0 and fields[0].bit_width == size:
+            fields = []
+        if dim > 1 and name.endswith("[%s]"):
+            registers.append(Register(prefix + cxx_name(name[:-4]), description, offset, size,
+                                      fields, dim, dim_increment))
+        elif dim > 1:
+            for i, index in enumerate(dim_indices(child, dim)):
+                registers.append(Register(prefix + cxx_name(name.replace("%s", index)),
+                                          description.replace("%s", index),
+                                          offset + i * dim_increment, size, fields))
+        else:
+            registers.append(Register(prefix + cxx_name(name), description, offset, size, fields))
+    return registers
+
+
+class Peripheral:
+    def __init__(self, node, peripherals, default_size):
+        self.name = cxx_name(child_text(node, "name"))
+        base = peripherals.get(node.get("derivedFrom"))
+        self.description = child_text(node, "description",
+                                      base.description if base is not None else self.name)
+        size = parse_int(child_text(node, "size", str(default_size)))
+        registers_node = node.find("registers")
+        if registers_node is not None:
+            self.registers = parse_registers(registers_node, size)
+        elif base is not None:
+            self.registers = base.registers
+        else:
+            self.registers = []
+        for register in self.registers:
+            names = [f.name for f in register.fields]
+            for f in register.fields:
+                # A data member may not have the name of the class.
+                if f.name == register.name or names.count(f.name) > 1:
+                    f.name = f.name + "_" + str(f.bit_offset)
+
+
+def generate_param(p):
+    guard = "%s_MMIO_PARAMS_HPP" % p.name.upper()
+    out = ["/*",
+           "   Register and field offset and size definitions for peripheral %s." % p.name,
+           "   SPDX-License-Identifier: Unlicense",
+           "*/",
+           "",
+           "#ifndef %s" % guard,
+           "#define %s" % guard,
+           "",
+           "#include <cstdint>",
+           "",
+           "namespace mmio_param {",
+           "    /* %s */" % comment(p.description),
+           "    namespace %s {" % p.name]
+    for r in p.registers:
+        out += ["       /* %s */" % comment(r.description),
+                "       struct %s_r {" % r.name,
+                "           using datatype = %s;" % uint_type(r.size),
+                "           static constexpr unsigned int offset = %s;" % hex(r.offset),
+                "           static constexpr unsigned int bit_width = %d;" % r.size,
+                "           static constexpr unsigned int field_count = %d;" % len(r.fields)]
+        if r.dim > 1:
+            out += ["           static constexpr unsigned int dim = %d;" % r.dim,
+                    "           static constexpr unsigned int dim_increment = %s;" % hex(r.dim_increment)]
+        for f in r.fields:
+            out += ["           /* %s */" % comment(f.description),
+                    "           struct %s_f {" % f.name,
+                    "               using datatype = %s;" % field_type(f.bit_width),
+                    "               static constexpr unsigned int bit_offset = %d;" % f.bit_offset,
+                    "               static constexpr unsigned int bit_width = %d;" % f.bit_width,
+                    "               static constexpr %s bit_mask = %s;" % (uint_type(r.size), hex(f.bit_mask)),
+                    "           }; /* %s_f */" % f.name]
+        out += ["       }; /* %s_r */" % r.name]
+    out += ["    }",
+            "}",
+            "",
+            "#endif // %s" % guard,
+            ""]
+    return "\n".join(out)
+
+
+def generate_regs(p):
+    guard = "%s_MMIO_REGS_HPP" % p.name.upper()
+    out = ["/*",
+           "   Register class and field definition for peripheral %s." % p.name,
+           "   SPDX-License-Identifier: Unlicense",
+           "*/",
+           "",
+           "#ifndef %s" % guard,
+           "#define %s" % guard,
+           "",
+           "#include <cstdint>",
+           '#include "mmio_device.hpp"',
+           '#include "%s_mmio_param.hpp"' % p.name,
+           "",
+           "namespace mmio_regs {",
+           "    /* %s */" % comment(p.description)]
+    if any(r.dim > 1 for r in p.registers):
+        out += ["    /* INDEX selects the register of a register array (dim > 1). */"]
+    out += ["    namespace %s {" % p.name]
+    for r in p.registers:
+        param = "mmio_param::%s::%s_r" % (p.name, r.name)
+        out += ["        /* %s */" % comment(r.description)]
+        if r.dim > 1:
+            base = "BASE_ADDR + INDEX*%s::dim_increment" % param
+            out += ["        template<const std::uintptr_t BASE_ADDR,",
+                    "                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access,",
+                    "                 unsigned int INDEX=0> class %s " % r.name]
+        else:
+            base = "BASE_ADDR"
+            out += ["        template<const std::uintptr_t BASE_ADDR,",
+                    "                 template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class %s " % r.name]
+        out += ["            : public mmio_device::reg<%s, " % base,
+                "                                %s, ACCESS> {" % param]
+        if r.dim > 1:
+            out += ['            static_assert(INDEX < %s::dim, "Register array index out of range");' % param]
+        if r.fields:
+            out += ["        public:"]
+        for f in r.fields:
+            out += ["            /* %s */" % comment(f.description),
+                    "            mmio_device::reg_field<%s, %s, %s::%s_f, ACCESS> %s;"
+                    % (base, param, param, f.name, f.name)]
+        out += ["        }; /* %s */" % r.name]
+    out += ["    } /* %s */" % p.name,
+            "} /* mmio_regs */",
+            "",
+            "#endif // %s" % guard,
+            ""]
+    return "\n".join(out)
+
+
+def generate_dev(p, shadowed):
+    guard = "%s_MMIO_DEV_HPP" % p.name.upper()
+    unknown = set(shadowed) - set(r.name for r in p.registers)
+    if unknown:
+        raise ValueError("%s has no registers: %s" % (p.name, ", ".join(sorted(unknown))))
+    out = ["/*",
+           "   Register structure definition of peripheral %s." % p.name,
+           "   SPDX-License-Identifier: Unlicense",
+           "*/",
+           "",
+           "#ifndef %s" % guard,
+           "#define %s" % guard,
+           "",
+           "#include <cstdint>",
+           '#include "mmio_device.hpp"',
+           '#include "%s_mmio_regs.hpp"' % p.name,
+           "",
+           "namespace driver {",
+           "",
+           "/*   %s */" % comment(p.description)]
+    if shadowed:
+        names = [r.name for r in p.registers if r.name in shadowed]
+        out += ["/*   SHADOW_ACCESS is the access policy of the write-mostly registers: %s." % ", ".join(names),
+                "     Use mmio_device::shadow_access to keep a RAM copy and avoid bus reads on read-modify-write.",
+                "     ACCESS is the access policy of the other registers, e.g. mmio_sim::sim_access on a host. */"]
+    if any(r.dim > 1 for r in p.registers):
+        out += ["/*   Register arrays are member templates indexed at compile time, e.g. %s_dev.%s<1>. */"
+                % (p.name, next(r.name for r in p.registers if r.dim > 1))]
+    out += ["template<std::uintptr_t BASE_ADDR,"]
+    if shadowed:
+        out += ["         template<std::uintptr_t, class> class SHADOW_ACCESS=mmio_device::direct_access,"]
+    out += ["         template<std::uintptr_t, class> class ACCESS=mmio_device::direct_access> class %s_dev  {" % p.name,
+            "public:"]
+    for r in p.registers:
+        access = "SHADOW_ACCESS" if r.name in shadowed else "ACCESS"
+        out += ["    /* %s */" % comment(r.description)]
+        if r.dim > 1:
+            out += ["   template<unsigned int INDEX> static inline mmio_regs::%s::%s<BASE_ADDR, %s, INDEX> %s;"
+                    % (p.name, r.name, access, r.name)]
+        else:
+            out += ["   mmio_regs::%s::%s<BASE_ADDR, %s> %s;" % (p.name, r.name, access, r.name)]
+        out += ["   "]
+    if shadowed:
+        out += ["    /* Load the RAM copies of the SHADOW_ACCESS registers, they may have been written by a boot loader. */",
+                "   %s_dev(void) {" % p.name]
+        out += ["       %s.sync();" % r.name for r in p.registers if r.name in shadowed]
+        out += ["   }",
+                "   "]
+    out += ["}; /* %s_dev  */" % p.name,
+            "",
+            "}",
+            "",
+            "#endif // %s" % guard,
+            ""]
+    return "\n".join(out)
+
+
+def write_if_changed(path, text):
+    """ Keep the timestamp of unchanged headers, so dependent objects are not rebuilt. """
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == text:
+                return
+    with open(path, "w") as f:
+        f.write(text)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Generate mmio_param/mmio_regs/mmio_dev headers from an SVD file.")
+    parser.add_argument("svd", help="CMSIS SVD file")
+    parser.add_argument("output", help="Output directory")
+    parser.add_argument("--peripheral", action="append", default=[],
+                        help="Peripheral to generate (default: all)")
+    parser.add_argument("--shadow", action="append", default=[], metavar="PERIPHERAL=REG,REG",
+                        help="Registers with the SHADOW_ACCESS policy")
+    args = parser.parse_args(argv)
+
+    shadow = {}
+    for spec in args.shadow:
+        name, regs = spec.split("=", 1)
+        shadow[cxx_name(name)] = [cxx_name(r) for r in regs.split(",")]
+
+    device = ET.parse(args.svd).getroot()
+    default_size = parse_int(child_text(device, "size", "32"))
+    peripherals = {}
+    for node in device.find("peripherals").findall("peripheral"):
+        peripheral = Peripheral(node, peripherals, default_size)
+        peripherals[child_text(node, "name")] = peripheral
+
+    selected = set(cxx_name(p) for p in args.peripheral)
+    os.makedirs(args.output, exist_ok=True)
+    for p in peripherals.values():
+        if selected and p.name not in selected:
+            continue
+        shadowed = shadow.get(p.name, [])
+        write_if_changed(os.path.join(args.output, "%s_mmio_param.hpp" % p.name), generate_param(p))
+        write_if_changed(os.path.join(args.output, "%s_mmio_regs.hpp" % p.name), generate_regs(p))
+        write_if_changed(os.path.join(args.output, "%s_mmio_dev.hpp" % p.name), generate_dev(p, shadowed))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))